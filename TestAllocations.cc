@@ -0,0 +1,256 @@
+#include "catch.hpp"
+#include "GraphReader.h"
+#include "BipartiteGraph.h"
+#include "GraphIndex.h"
+#include "ClassificationNetwork.h"
+#include "ClassifiedPopular.h"
+#include "ClassifiedRankMaximal.h"
+#include "RelaxedStable.h"
+#include "Statistics.h"
+#include "PartnerList.h"
+#include "Vertex.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// every allocation of the test program goes through these
+static std::atomic<unsigned long> num_allocations(0);
+
+void* operator new(std::size_t size) {
+    ++num_allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// allocations made since the counter was created
+class AllocationCounter {
+private:
+    unsigned long start_;
+
+public:
+    AllocationCounter() : start_(num_allocations) {}
+    unsigned long allocations() const { return num_allocations - start_; }
+};
+
+// n residents and n hospitals with quotas of one, resident a_i lists the
+// hospitals b_i, b_(i+1) and b_(i+2) (modulo n) and the hospitals list the
+// residents in the opposite order
+std::unique_ptr<BipartiteGraph> make_ring_graph(int n) {
+    BipartiteGraph::ContainerType A, B;
+    std::vector<VertexPtr> residents, hospitals;
+    for (int i = 0; i < n; ++i) {
+        residents.emplace_back(std::make_shared<Vertex>("a" + std::to_string(i)));
+        hospitals.emplace_back(std::make_shared<Vertex>("b" + std::to_string(i)));
+        A.emplace(residents.back()->get_id(), residents.back());
+        B.emplace(hospitals.back()->get_id(), hospitals.back());
+    }
+
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            residents[i]->get_preference_list().emplace_back(hospitals[(i + j) % n]);
+            hospitals[(i + j) % n]->get_preference_list().emplace_back(residents[i]);
+        }
+    }
+
+    return std::unique_ptr<BipartiteGraph>(new BipartiteGraph(A, B));
+}
+
+// the queries of the classification algorithms (ClassifiedPopular,
+// ClassifiedRankMaximal), Statistics and RelaxedStable look up roles,
+// ranks and partners per edge, none of them may allocate
+TEST_CASE("graph queries do not allocate", "[allocations]") {
+    GraphReader reader(TESTS_DIR "/example_paper.txt");
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+    GraphIndex index(*G);
+
+    SECTION("partitions and preference lists") {
+        unsigned long sum = 0;
+        AllocationCounter counter;
+
+        const auto& A = G->get_A_partition();
+        const auto& B = G->get_B_partition();
+        for (const auto& it : A) {
+            auto& pref_list = it.second->get_preference_list();
+
+            for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+                auto v = pref_list.get_vertex(*i);
+                sum += pref_list.get_rank(*i) + B.count(v->get_id());
+                sum += pref_list.find(v) + pref_list.is_ranked_better(v, v);
+            }
+        }
+
+        for (const auto& v : G->get_B_vertices()) {
+            sum += v->get_lower_quota() + v->get_upper_quota();
+            sum += A.find(v->get_id()) == A.end();
+        }
+
+        auto allocations = counter.allocations();
+        REQUIRE(allocations == 0);
+        REQUIRE(sum > 0);
+    }
+
+    SECTION("indices of the vertices and edges") {
+        unsigned long sum = 0;
+        AllocationCounter counter;
+
+        const auto& A = G->get_A_vertices();
+        const auto& B = G->get_B_vertices();
+        for (IndexType a = 0; a < index.num_A_vertices(); ++a) {
+            sum += index.is_A_vertex(A[a]) + index.get_A_quota(a);
+
+            for (auto e = index.A_begin(a); e < index.A_end(a); ++e) {
+                auto b = index.get_head(e);
+                sum += index.get_A_rank(e) + index.get_B_rank(e);
+                sum += index.is_B_vertex(B[b]) + index.find_edge(a, b);
+            }
+        }
+
+        for (IndexType b = 0; b < index.num_B_vertices(); ++b) {
+            for (auto i = index.B_begin(b); i < index.B_end(b); ++i) {
+                sum += index.get_tail(index.B_edge(i)) + index.get_B_quota(b);
+            }
+        }
+
+        auto allocations = counter.allocations();
+        REQUIRE(allocations == 0);
+        REQUIRE(sum > 0);
+    }
+
+    SECTION("labels and matched edges of the classification network") {
+        ClassificationNetwork network(index);
+        for (IndexType a = 0; a < index.num_A_vertices(); ++a) {
+            for (auto e = index.A_begin(a); e < index.A_end(a); ++e) {
+                network.add_edge(e, index.get_A_rank(e));
+            }
+
+            network.add_last_resort_edge(a, index.A_end(a) - index.A_begin(a) + 1);
+        }
+
+        network.compute_max_flow();
+        network.decompose_nodes_STU();
+
+        unsigned long sum = 0;
+        AllocationCounter counter;
+
+        for (IndexType a = 0; a < index.num_A_vertices(); ++a) {
+            sum += network.get_A_label(a) + network.is_last_resort_matched(a);
+
+            for (auto e = index.A_begin(a); e < index.A_end(a); ++e) {
+                sum += network.is_matched(e) + network.get_B_label(index.get_head(e));
+            }
+        }
+
+        network.for_each_relabelled_edge([&sum] (IndexType e) { sum += e; });
+
+        auto allocations = counter.allocations();
+        REQUIRE(allocations == 0);
+        REQUIRE(sum > 0);
+    }
+
+    SECTION("partners in a matching") {
+        ClassifiedPopular alg(G, true);
+        alg.compute_matching();
+        const auto& M = alg.get_matched_pairs();
+
+        unsigned long sum = 0;
+        AllocationCounter counter;
+
+        for (const auto& it : M) {
+            const auto& partners = it.second;
+
+            for (auto i = partners.cbegin(), e = partners.cend(); i != e; ++i) {
+                auto v = partners.get_vertex(i);
+                sum += partners.get_rank(i) + (partners.find(v) != e);
+                sum += M.count(v) + index.is_A_vertex(it.first);
+            }
+        }
+
+        auto allocations = counter.allocations();
+        REQUIRE(allocations == 0);
+        REQUIRE(sum > 0);
+    }
+}
+
+// the algorithms themselves allocate their arrays once per call, and the
+// matchings they return a map entry and a partner per matched vertex, a
+// copy of a partition or a map keyed by the vertices costs one allocation
+// per vertex instead
+TEST_CASE("algorithm queries do not allocate per vertex", "[allocations]") {
+    const int n = 2048;
+    std::unique_ptr<BipartiteGraph> G = make_ring_graph(n);
+
+    SECTION("statistics of a matching") {
+        ClassifiedPopular alg(G, true);
+        REQUIRE(alg.compute_matching());
+        const auto& M = alg.get_matched_pairs();
+
+        // the deficiency of the graph is computed by the first call
+        Statistics statistics(*G);
+        statistics.get_statistics(M);
+
+        AllocationCounter counter;
+        auto metrics = statistics.get_statistics(M);
+        auto allocations = counter.allocations();
+
+        REQUIRE(metrics.S == n);
+        REQUIRE(allocations < n / 8);
+    }
+
+    SECTION("relaxed stability of a matching") {
+        ClassifiedPopular alg(G, true);
+        REQUIRE(alg.compute_matching());
+        auto& M = alg.get_matched_pairs();
+        RelaxedStable relaxed_stable(G);
+
+        AllocationCounter counter;
+        bool is_relaxed_stable = relaxed_stable.is_relaxed_stable(G, M);
+        auto allocations = counter.allocations();
+
+        REQUIRE(is_relaxed_stable);
+        REQUIRE(allocations <= 1);
+    }
+
+    SECTION("matchings of CPM and CRMM") {
+        ClassifiedPopular cpm(G, true);
+        ClassifiedRankMaximal crmm(G, true);
+
+        AllocationCounter cpm_counter;
+        REQUIRE(cpm.compute_matching());
+        auto cpm_allocations = cpm_counter.allocations();
+
+        AllocationCounter crmm_counter;
+        REQUIRE(crmm.compute_matching());
+        auto crmm_allocations = crmm_counter.allocations();
+
+        // four for every matched pair (two map entries and two partners),
+        // and the arrays of the flow network
+        REQUIRE(cpm.get_matched_pairs().size() == 2 * n);
+        REQUIRE(crmm.get_matched_pairs().size() == 2 * n);
+        REQUIRE(cpm_allocations < 4 * n + n / 4);
+        REQUIRE(crmm_allocations < 4 * n + n / 4);
+    }
+}
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "GraphReader.h"
+#include "BipartiteGraph.h"
+#include "ClassifiedPopular.h"
+#include "ClassifiedRankMaximal.h"
+#include "FlowNetwork.h"
+#include "PartnerList.h"
+#include "Vertex.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// selects a decomposition mode for the lifetime of the guard
+class DecompositionModeGuard {
+private:
+    FlowNetwork::DecompositionMode previous_;
+
+public:
+    DecompositionModeGuard(FlowNetwork::DecompositionMode mode)
+        : previous_(FlowNetwork::get_decomposition_mode())
+    {
+        FlowNetwork::set_decomposition_mode(mode);
+    }
+
+    ~DecompositionModeGuard() {
+        FlowNetwork::set_decomposition_mode(previous_);
+    }
+};
+
+// number of pairs of every rank on the side of A
+std::vector<unsigned> signature(const BipartiteGraph& G, const MatchedPairListType& M) {
+    std::vector<unsigned> counts;
+
+    for (const auto& it : G.get_A_partition()) {
+        auto M_a = M.find(it.second);
+        if (M_a == M.end()) {
+            continue;
+        }
+
+        const auto& partners = M_a->second;
+        for (auto i = partners.cbegin(); i != partners.cend(); ++i) {
+            auto rank = partners.get_rank(i);
+            if (counts.size() < (std::size_t) rank) {
+                counts.resize(rank, 0);
+            }
+
+            ++counts[rank - 1];
+        }
+    }
+
+    return counts;
+}
+
+// many-to-many instance with ties, residents have quotas of one or two and
+// hospitals of one to three
+std::unique_ptr<BipartiteGraph> make_random_graph(std::mt19937& rng, int nA, int nB) {
+    BipartiteGraph::ContainerType A, B;
+    std::vector<VertexPtr> hospitals;
+    std::uniform_int_distribution<int> A_quota(1, 2), B_quota(1, 3);
+
+    for (int i = 0; i < nA; ++i) {
+        auto id = "r" + std::to_string(i);
+        A.emplace(id, std::make_shared<Vertex>(id, 0, A_quota(rng)));
+    }
+
+    for (int j = 0; j < nB; ++j) {
+        hospitals.emplace_back(std::make_shared<Vertex>("h" + std::to_string(j), 0, B_quota(rng)));
+        B.emplace(hospitals.back()->get_id(), hospitals.back());
+    }
+
+    std::uniform_int_distribution<int> degree(1, 6), hospital(0, nB - 1), coin(0, 3);
+    for (auto& it : A) {
+        auto& pref_list = it.second->get_preference_list();
+        std::vector<char> listed(nB, false);
+
+        for (int k = degree(rng); k > 0; --k) {
+            auto j = hospital(rng);
+            if (listed[j]) {
+                continue;
+            }
+
+            listed[j] = true;
+            if (not pref_list.empty() and coin(rng) == 0) {
+                pref_list.emplace_back_with_tie(hospitals[j]);
+            } else {
+                pref_list.emplace_back(hospitals[j]);
+            }
+
+            hospitals[j]->get_preference_list().emplace_back(it.second);
+        }
+    }
+
+    return std::unique_ptr<BipartiteGraph>(new BipartiteGraph(A, B));
+}
+
+// -l and -c with every decomposition checked against a full one, and the
+// same rank-maximal signature as without the check
+void check_decompositions(const std::unique_ptr<BipartiteGraph>& G) {
+    std::vector<unsigned> expected;
+    {
+        DecompositionModeGuard guard(FlowNetwork::FULL);
+        ClassifiedRankMaximal crmm(G, true);
+        crmm.compute_matching();
+        expected = signature(*G, crmm.get_matched_pairs());
+    }
+
+    DecompositionModeGuard guard(FlowNetwork::VERIFY);
+    ClassifiedRankMaximal crmm(G, true);
+    REQUIRE_NOTHROW(crmm.compute_matching());
+    REQUIRE(signature(*G, crmm.get_matched_pairs()) == expected);
+
+    ClassifiedPopular cpm(G, true);
+    REQUIRE_NOTHROW(cpm.compute_matching());
+}
+
+}
+
+TEST_CASE("incremental decompositions match the full ones", "[decomposition]") {
+    SECTION("instances of the tests") {
+        for (auto file : {"/example_paper.txt", "/2pop_matchings.txt", "/hrlq_m6.txt",
+                          "/max_mat_not_all_popular.txt", "/diff_stable_diff_pop1.txt",
+                          "/mp_lq.txt", "/cpm/cpm_matchings_1.txt", "/cpm/cpm_matchings_2.txt",
+                          "/cpm/cpm_matchings_3.txt", "/cpm/cpm_matchings_4.txt",
+                          "/cpm/cpm_matchings_5.txt", "/cpm/cpm_matchings_6.txt",
+                          "/cpm/cpm_unit_ties.txt", "/sea-2018/figure1.txt",
+                          "/switching/cycle_tree.txt"}) {
+            INFO(file);
+            GraphReader reader((std::string(TESTS_DIR) + file).c_str());
+            check_decompositions(reader.read_graph());
+        }
+    }
+
+    SECTION("random instances with quotas and ties") {
+        std::mt19937 rng(39);
+        std::uniform_int_distribution<int> size(2, 80);
+
+        for (int i = 0; i < 100; ++i) {
+            INFO("instance " << i);
+            check_decompositions(make_random_graph(rng, size(rng), size(rng)));
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "BipartiteGraph.h"
+#include "GraphIndex.h"
+#include "HopcroftKarp.h"
+#include "PartnerList.h"
+#include "Vertex.h"
+#include <stdexcept>
+
+namespace {
+
+// a1 : b1, b2 and a2 : b1, every quota is one
+std::unique_ptr<BipartiteGraph> make_path_graph(BipartiteGraph::ContainerType& A,
+                                                BipartiteGraph::ContainerType& B)
+{
+    for (auto id : {"a1", "a2"}) {
+        A.emplace(id, std::make_shared<Vertex>(id));
+    }
+
+    for (auto id : {"b1", "b2"}) {
+        B.emplace(id, std::make_shared<Vertex>(id));
+    }
+
+    A["a1"]->get_preference_list().emplace_back(B["b1"]);
+    A["a1"]->get_preference_list().emplace_back(B["b2"]);
+    A["a2"]->get_preference_list().emplace_back(B["b1"]);
+
+    return std::unique_ptr<BipartiteGraph>(new BipartiteGraph(A, B));
+}
+
+}
+
+TEST_CASE("augmenting paths of a matching which is not maximum", "[hopcroft_karp]") {
+    BipartiteGraph::ContainerType A, B;
+    auto G = make_path_graph(A, B);
+
+    MatchedPairListType M;
+    M[A["a1"]].add_partner(std::make_pair(1, B["b1"]));
+    M[B["b1"]].add_partner(std::make_pair(1, A["a1"]));
+
+    HopcroftKarp hk(*G);
+    REQUIRE(hk.has_augmenting_path(M));
+
+    SECTION("without the paths") {
+        auto result = hk.check(M);
+        REQUIRE_FALSE(result.is_maximum);
+        REQUIRE(result.cardinality == 1);
+        REQUIRE(result.max_cardinality == 2);
+        REQUIRE(result.paths.empty());
+    }
+
+    SECTION("with the paths") {
+        auto result = hk.check(M, true);
+        REQUIRE_FALSE(result.is_maximum);
+        REQUIRE(result.max_cardinality == 2);
+
+        // a2 -> b1 = a1 -> b2 is the only augmenting path
+        REQUIRE(result.paths.size() == 1);
+        HopcroftKarp::PathType path{A["a2"], B["b1"], A["a1"], B["b2"]};
+        REQUIRE(result.paths[0] == path);
+    }
+
+    SECTION("a maximum matching has no paths") {
+        M.clear();
+        M[A["a1"]].add_partner(std::make_pair(2, B["b2"]));
+        M[B["b2"]].add_partner(std::make_pair(1, A["a1"]));
+        M[A["a2"]].add_partner(std::make_pair(1, B["b1"]));
+        M[B["b1"]].add_partner(std::make_pair(1, A["a2"]));
+
+        auto result = hk.check(M, true);
+        REQUIRE(result.is_maximum);
+        REQUIRE(result.cardinality == 2);
+        REQUIRE(result.max_cardinality == 2);
+        REQUIRE(result.paths.empty());
+        REQUIRE_FALSE(hk.has_augmenting_path(M));
+    }
+}
+
+TEST_CASE("a vertex belongs to one graph at a time", "[graph_index]") {
+    BipartiteGraph::ContainerType A, B;
+    auto G = make_path_graph(A, B);
+    GraphIndex index(*G);
+
+    REQUIRE(index.is_A_vertex(A["a2"]));
+    REQUIRE_THROWS_AS(BipartiteGraph(A, B), std::logic_error);
+
+    // the graph which failed did not take the vertices over
+    REQUIRE(index.is_A_vertex(A["a2"]));
+    REQUIRE(index.is_B_vertex(B["b2"]));
+
+    G.reset();
+    REQUIRE(A["a2"]->get_graph() == nullptr);
+
+    BipartiteGraph H(A, B);
+    REQUIRE(A["a2"]->get_graph() == &H);
+}
@@ -0,0 +1,140 @@
+#include "catch.hpp"
+#include "BipartiteGraph.h"
+#include "ClassifiedPopular.h"
+#include "ClassifiedRankMaximal.h"
+#include "FlowNetwork.h"
+#include "Parallel.h"
+#include "PartnerList.h"
+#include "Statistics.h"
+#include "Vertex.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+typedef std::vector<std::tuple<IdType, IdType, RankType>> PairListType;
+
+// the pairs of M as ids, in the order of the vertices of M
+PairListType get_pairs(const MatchedPairListType& M) {
+    PairListType pairs;
+
+    for (const auto& it : M) {
+        const auto& partners = it.second;
+        for (auto i = partners.cbegin(); i != partners.cend(); ++i) {
+            pairs.emplace_back(it.first->get_id(), partners.get_vertex(i)->get_id(),
+                               partners.get_rank(i));
+        }
+    }
+
+    return pairs;
+}
+
+// many-to-one instance with ties, large enough that the levels of the
+// breadth first searches of the flow networks (and the loops over the
+// vertices) are split into blocks of PARALLEL_GRAIN_SIZE
+std::unique_ptr<BipartiteGraph> make_large_graph(int nA, int nB) {
+    std::mt19937 rng(41);
+    BipartiteGraph::ContainerType A, B;
+    std::vector<VertexPtr> hospitals;
+    std::uniform_int_distribution<int> B_quota(1, 3);
+
+    for (int i = 0; i < nA; ++i) {
+        auto id = "r" + std::to_string(i);
+        A.emplace(id, std::make_shared<Vertex>(id));
+    }
+
+    for (int j = 0; j < nB; ++j) {
+        hospitals.emplace_back(std::make_shared<Vertex>("h" + std::to_string(j), 0, B_quota(rng)));
+        B.emplace(hospitals.back()->get_id(), hospitals.back());
+    }
+
+    std::uniform_int_distribution<int> degree(1, 4), hospital(0, nB - 1), coin(0, 3);
+    for (auto& it : A) {
+        auto& pref_list = it.second->get_preference_list();
+        std::vector<int> listed;
+
+        for (int k = degree(rng); k > 0; --k) {
+            auto j = hospital(rng);
+            if (std::find(listed.begin(), listed.end(), j) != listed.end()) {
+                continue;
+            }
+
+            listed.emplace_back(j);
+            if (not pref_list.empty() and coin(rng) == 0) {
+                pref_list.emplace_back_with_tie(hospitals[j]);
+            } else {
+                pref_list.emplace_back(hospitals[j]);
+            }
+
+            hospitals[j]->get_preference_list().emplace_back(it.second);
+        }
+    }
+
+    return std::unique_ptr<BipartiteGraph>(new BipartiteGraph(A, B));
+}
+
+// what CRMM, CPM and Statistics compute with the given number of threads
+struct Outputs {
+    PairListType crmm, cpm;
+    bool has_popular;
+    unsigned long int BPC, BR;
+    std::vector<unsigned long int> rank_profile;
+};
+
+Outputs compute_outputs(const std::unique_ptr<BipartiteGraph>& G, unsigned nthreads) {
+    set_parallel_threads(nthreads);
+    Outputs outputs;
+
+    ClassifiedRankMaximal crmm(G, true);
+    crmm.compute_matching();
+    outputs.crmm = get_pairs(crmm.get_matched_pairs());
+
+    ClassifiedPopular cpm(G, true);
+    outputs.has_popular = cpm.compute_matching();
+    outputs.cpm = get_pairs(cpm.get_matched_pairs());
+
+    Statistics statistics(*G);
+    auto metrics = statistics.get_statistics(crmm.get_matched_pairs());
+    outputs.BPC = metrics.BPC;
+    outputs.BR = metrics.BR;
+    outputs.rank_profile = metrics.rank_profile;
+
+    set_parallel_threads(0);
+    return outputs;
+}
+
+}
+
+TEST_CASE("results do not depend on the number of threads", "[parallel]") {
+    // four grains of applicants, so that four threads split the level of
+    // the applicants in every search
+    const int nA = 4 * PARALLEL_GRAIN_SIZE + 1000;
+    const int nB = nA / 3;
+    auto G = make_large_graph(nA, nB);
+
+    set_parallel_threads(4);
+    REQUIRE(parallel_blocks(nA) == 4);
+    set_parallel_threads(0);
+
+    auto algorithm = FlowNetwork::get_default_algorithm();
+    for (auto max_flow : {FlowNetwork::DINIC, FlowNetwork::PUSH_RELABEL, FlowNetwork::AUTO}) {
+        INFO("algorithm " << max_flow);
+        FlowNetwork::set_default_algorithm(max_flow);
+
+        auto serial = compute_outputs(G, 1);
+        auto parallel = compute_outputs(G, 4);
+
+        REQUIRE(serial.crmm.size() > 0);
+        REQUIRE(serial.crmm == parallel.crmm);
+        REQUIRE(serial.has_popular == parallel.has_popular);
+        REQUIRE(serial.cpm == parallel.cpm);
+        REQUIRE(serial.BPC == parallel.BPC);
+        REQUIRE(serial.BR == parallel.BR);
+        REQUIRE(serial.rank_profile == parallel.rank_profile);
+    }
+
+    FlowNetwork::set_default_algorithm(algorithm);
+}
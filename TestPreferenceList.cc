@@ -4,15 +4,27 @@
 
 TEST_CASE("preference list", "[pref_list]") {
     PreferenceList pref_list;
-    std::shared_ptr<Vertex> v1 = "v1";
-    std::shared_ptr<Vertex> v2 = "v2";
-    std::shared_ptr<Vertex> v2 = "v2";
+    auto v1 = std::make_shared<Vertex>("v1");
+    auto v2 = std::make_shared<Vertex>("v2");
+    auto v3 = std::make_shared<Vertex>("v3");
 
     REQUIRE(pref_list.empty());
 
     SECTION("adding vertices to the pref_list_") {
         pref_list.emplace_back(v1);
         REQUIRE_FALSE(pref_list.empty());
+        REQUIRE(pref_list.get_vertex(pref_list.find(v1)) == v1);
+        REQUIRE(pref_list.find(v2) == pref_list.end());
     }
-}
 
+    SECTION("ties share a rank") {
+        pref_list.emplace_back(v1);
+        pref_list.emplace_back_with_tie(v2);
+        pref_list.emplace_back(v3);
+
+        REQUIRE(pref_list.size() == 3);
+        REQUIRE(pref_list.get_rank(pref_list.find(v1)) == pref_list.get_rank(pref_list.find(v2)));
+        REQUIRE(pref_list.is_ranked_better(v2, v3));
+        REQUIRE_FALSE(pref_list.is_ranked_better(v1, v2));
+    }
+}
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+#include "GraphReader.h"
+#include "BipartiteGraph.h"
+#include "ClassifiedPopular.h"
+#include "ClassifiedRankMaximal.h"
+#include "UnitPopular.h"
+#include "UnitRankMaximal.h"
+#include "UnitMatching.h"
+#include "PartnerList.h"
+#include "Vertex.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// number of applicants matched to a post of every rank
+std::vector<unsigned> signature(const BipartiteGraph& G, const MatchedPairListType& M) {
+    std::vector<unsigned> counts;
+
+    for (const auto& it : G.get_A_partition()) {
+        auto M_a = M.find(it.second);
+        if (M_a == M.end()) {
+            continue;
+        }
+
+        const auto& partners = M_a->second;
+        for (auto i = partners.cbegin(); i != partners.cend(); ++i) {
+            auto rank = partners.get_rank(i);
+            if (counts.size() < (std::size_t) rank) {
+                counts.resize(rank, 0);
+            }
+
+            ++counts[rank - 1];
+        }
+    }
+
+    return counts;
+}
+
+// house allocation instance with quotas of one, every applicant lists a
+// few posts with ties, the posts list the applicants which list them
+std::unique_ptr<BipartiteGraph> make_random_graph(std::mt19937& rng, int nA, int nB) {
+    BipartiteGraph::ContainerType A, B;
+    std::vector<VertexPtr> posts;
+
+    for (int i = 0; i < nA; ++i) {
+        auto id = "a" + std::to_string(i);
+        A.emplace(id, std::make_shared<Vertex>(id));
+    }
+
+    for (int j = 0; j < nB; ++j) {
+        posts.emplace_back(std::make_shared<Vertex>("b" + std::to_string(j)));
+        B.emplace(posts.back()->get_id(), posts.back());
+    }
+
+    std::uniform_int_distribution<int> degree(1, 5), post(0, nB - 1), coin(0, 2);
+    for (auto& it : A) {
+        auto& pref_list = it.second->get_preference_list();
+        std::vector<char> listed(nB, false);
+
+        for (int k = degree(rng); k > 0; --k) {
+            auto j = post(rng);
+            if (listed[j]) {
+                continue;
+            }
+
+            listed[j] = true;
+            if (not pref_list.empty() and coin(rng) == 0) {
+                pref_list.emplace_back_with_tie(posts[j]);
+            } else {
+                pref_list.emplace_back(posts[j]);
+            }
+
+            posts[j]->get_preference_list().emplace_back(it.second);
+        }
+    }
+
+    return std::unique_ptr<BipartiteGraph>(new BipartiteGraph(A, B));
+}
+
+// the unit engines and the flow based ones agree on G
+void check_engines(const std::unique_ptr<BipartiteGraph>& G) {
+    UnitRankMaximal unit_rmm(G);
+    ClassifiedRankMaximal crmm(G, true);
+    REQUIRE(unit_rmm.compute_matching());
+    REQUIRE(crmm.compute_matching());
+    REQUIRE(signature(*G, unit_rmm.get_matched_pairs()) ==
+            signature(*G, crmm.get_matched_pairs()));
+
+    UnitPopular unit_pm(G);
+    ClassifiedPopular cpm(G, true);
+    REQUIRE(unit_pm.compute_matching() == cpm.compute_matching());
+}
+
+}
+
+TEST_CASE("unit engines agree with the flow based ones", "[unit_matching]") {
+    SECTION("instances of the tests") {
+        for (auto file : {"/example_paper.txt", "/2pop_matchings.txt",
+                          "/max_mat_not_all_popular.txt", "/diff_stable_diff_pop1.txt",
+                          "/cpm/cpm_unit_ties.txt"}) {
+            INFO(file);
+            GraphReader reader((std::string(TESTS_DIR) + file).c_str());
+            auto G = reader.read_graph();
+            REQUIRE(UnitRankMaximal::is_applicable(*G));
+            check_engines(G);
+        }
+    }
+
+    SECTION("random instances with ties") {
+        std::mt19937 rng(2018);
+        std::uniform_int_distribution<int> size(2, 60);
+
+        for (int i = 0; i < 200; ++i) {
+            INFO("instance " << i);
+            auto G = make_random_graph(rng, size(rng), size(rng));
+            check_engines(G);
+        }
+    }
+}
+
+TEST_CASE("unit matching augments along shortest paths", "[unit_matching]") {
+    // a1 is matched to b0, the free applicant a0 lists b0 before the free
+    // post b2, and a1 also lists the free post b1
+    UnitMatching matching(2, 3);
+    UnitMatching::Adjacency G;
+    G.end_applicant();
+    G.add_arc(0, 10);
+    G.end_applicant();
+    matching.maximum_matching(G, 3);
+    REQUIRE(matching.get_A_mate(1) == 0);
+
+    G.clear();
+    G.add_arc(0, 0);
+    G.add_arc(2, 1);
+    G.end_applicant();
+    G.add_arc(0, 10);
+    G.add_arc(1, 11);
+    G.end_applicant();
+
+    // a0 -> b2 is the only shortest augmenting path, a0 -> b0 = a1 -> b1
+    // is longer
+    matching.maximum_matching(G, 3);
+    REQUIRE(matching.get_A_mate(0) == 2);
+    REQUIRE(matching.get_A_edge(0) == 1);
+    REQUIRE(matching.get_A_mate(1) == 0);
+    REQUIRE(matching.get_A_edge(1) == 10);
+    REQUIRE(matching.get_B_mate(1) == UnitMatching::NONE);
+
+    matching.decompose(G);
+    REQUIRE(matching.get_B_label(1) == UnitMatching::EVEN);
+    REQUIRE(matching.get_A_label(1) == UnitMatching::ODD);
+    REQUIRE(matching.get_B_label(0) == UnitMatching::EVEN);
+}
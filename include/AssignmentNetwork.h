@@ -0,0 +1,39 @@
+#ifndef ASSIGNMENT_NETWORK_H
+#define ASSIGNMENT_NETWORK_H
+
+#include <vector>
+#include "FlowNetwork.h"
+#include "GraphIndex.h"
+#include "TDefs.h"
+
+/// flow network source -> A -> B -> sink of an instance, the quotas are the
+/// capacities of the edges from the source and to the sink, and the edge
+/// (a, b) has capacity one and the rank of b on the list of a as its cost
+/// the edges carrying flow are the matching
+class AssignmentNetwork {
+private:
+    const GraphIndex& index_;
+    FlowNetwork H_;
+    NodePtr source_, sink_;
+    std::vector<NodeType> arcs_;    // arc of every edge of the graph
+
+    NodeType A_node(IndexType a) const { return 2 + a; }
+    NodeType B_node(IndexType b) const { return 2 + index_.num_A_vertices() + b; }
+
+public:
+    AssignmentNetwork(const GraphIndex& index);
+    virtual ~AssignmentNetwork();
+
+    /// maximum flow, and minimum cost maximum flow with its cost in cost
+    FlowType compute_max_flow();
+    FlowType compute_min_cost_flow(CostType& cost);
+
+    /// does the edge e carry flow
+    bool is_matched(IndexType e) const;
+
+    /// adds the edges carrying flow to M, the partners are ranked as on the
+    /// preference lists, an unranked vertex in A with rank one
+    void get_matched_pairs(MatchedPairListType& M) const;
+};
+
+#endif
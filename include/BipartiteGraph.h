@@ -4,26 +4,43 @@
 #include <map>
 #include <memory>
 #include <ostream>
+#include <vector>
 #include "TDefs.h"
 
+class ReducedGraphCache;
+
 class BipartiteGraph {
 public:
     typedef std::map<IdType, VertexPtr> ContainerType;
     typedef ContainerType::iterator Iterator;
+    typedef std::vector<VertexPtr> IndexedContainerType;
 
 private:
     /// the partitions A and B
     ContainerType A_;
     ContainerType B_;
 
+    /// vertices of the partitions A and B in the order of their index
+    IndexedContainerType A_vertices_;
+    IndexedContainerType B_vertices_;
+
+    /// reduced graphs built from this graph
+    mutable std::unique_ptr<ReducedGraphCache> reduced_graphs_;
+
 public:
     BipartiteGraph(const ContainerType& A, const ContainerType& B);
     virtual ~BipartiteGraph();
 
     const ContainerType& get_A_partition() const;
     const ContainerType& get_B_partition() const;
+    const IndexedContainerType& get_A_vertices() const;
+    const IndexedContainerType& get_B_vertices() const;
     bool has_augmenting_path(const MatchedPairListType& M) const;
 
+    /// the cache of reduced graphs built from this graph, shared by all the
+    /// algorithms which run on it
+    ReducedGraphCache& get_reduced_graphs() const;
+
     friend std::ostream& operator<<(std::ostream& out,
                                     const std::unique_ptr<BipartiteGraph>& G);
 };
@@ -0,0 +1,99 @@
+#ifndef CLASSIFICATION_NETWORK_H
+#define CLASSIFICATION_NETWORK_H
+
+#include <ostream>
+#include <vector>
+#include "FlowNetwork.h"
+#include "GraphIndex.h"
+#include "TDefs.h"
+
+/// flow network of the classification trees of CPM and CRMM, with the
+/// degenerate trees contracted
+/// every applicant and every post has a tree with a root and one leaf per
+/// edge, and the edge (a, b) of the instance is the arc from the leaf of b
+/// in the tree of a to the leaf of a in the tree of b, without
+/// classifications every leaf is a class of one vertex with capacity one,
+/// so the path root(a) -> leaf -> leaf -> root(b) has no branching and is
+/// replaced by an arc of capacity one between the roots, and the last
+/// resort post of a becomes an arc from root(a) to the sink
+/// the roots get the labels they would have in the full network, as a
+/// leaf only has its path, and the edges carrying flow are the matching
+/// deleting an edge from an S node to another node which carries flow
+/// deletes in the full network the edge between a root and a leaf, and the
+/// edge between the leaves keeps its flow, so such an edge stays matched
+class ClassificationNetwork {
+public:
+    typedef GraphIndex::IndexListType IndexListType;
+
+    struct Statistics {
+        NodeType nodes;             // nodes of the network
+        NodeType edges;             // edges of the network (forward edges only)
+        NodeType nodes_saved;       // leaves and last resort nodes contracted
+        NodeType edges_saved;       // edges of the trees contracted
+    };
+
+private:
+    const GraphIndex& index_;
+    FlowNetwork H_;
+    NodePtr source_, sink_;
+    std::vector<NodeType> arcs_;                // arc of every edge of the graph, -1 if not added
+    std::vector<NodeType> last_resort_arcs_;    // arc to the last resort post of every applicant
+    std::vector<char> kept_;                    // was the edge deleted while carrying flow
+    std::vector<char> last_resort_kept_;        // same for the edge to the last resort post
+    IndexListType new_edges_;                   // edges added since the last deletion
+    Statistics stats_;
+
+    NodeType A_root(IndexType a) const { return 2 + a; }
+    NodeType B_root(IndexType b) const { return 2 + index_.num_A_vertices() + b; }
+
+public:
+    /// the roots of the trees, with the edges from the source to the roots
+    /// of the applicants and from the roots of the posts to the sink
+    ClassificationNetwork(const GraphIndex& index);
+    virtual ~ClassificationNetwork();
+
+    /// adds the edge e with the given rank, if it is not in the network
+    void add_edge(IndexType e, RankType rank);
+
+    /// adds the edge from a to its last resort post
+    void add_last_resort_edge(IndexType a, RankType rank);
+
+    /// maximum flow, decomposition into S, T and U nodes, and deletion of
+    /// the edges into S of the network
+    FlowType compute_max_flow();
+    void decompose_nodes_STU();
+    void delete_edges_into_S();
+
+    /// labels of the roots given by the last decomposition
+    Node::DecompositionLabel get_A_label(IndexType a) const;
+    Node::DecompositionLabel get_B_label(IndexType b) const;
+
+    /// does the edge e (or the edge to the last resort post of a) carry flow
+    bool is_matched(IndexType e) const;
+    bool is_last_resort_matched(IndexType a) const;
+
+    /// calls visit(e) for every edge of a vertex whose root was relabelled
+    /// by the last decomposition, an edge may be visited twice
+    template <typename Visitor>
+    void for_each_relabelled_edge(Visitor visit) const {
+        for (NodeType node : H_.get_relabelled_nodes()) {
+            if (node >= B_root(0) && node < B_root(index_.num_B_vertices())) {
+                IndexType b = node - B_root(0);
+                for (IndexType i = index_.B_begin(b); i < index_.B_end(b); ++i) {
+                    visit(index_.B_edge(i));
+                }
+            } else if (node >= A_root(0) && node < B_root(0)) {
+                IndexType a = node - A_root(0);
+                for (IndexType e = index_.A_begin(a); e < index_.A_end(a); ++e) {
+                    visit(e);
+                }
+            }
+        }
+    }
+
+    const Statistics& get_statistics() const;
+};
+
+std::ostream& operator<<(std::ostream& out, const ClassificationNetwork::Statistics& stats);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef DYNAMIC_POPULAR_H
+#define DYNAMIC_POPULAR_H
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+#include "BipartiteGraph.h"
+#include "TDefs.h"
+
+/// popular matching in a house allocation instance with strict preferences
+/// and quotas of one, kept up to date while applicants change their lists,
+/// join or leave (the posts are those of the graph given at construction)
+/// the reduced graph has the edges from every applicant a to f(a), its
+/// first choice, and to s(a), its most preferred post which is not the
+/// first choice of any applicant (or its last resort post), and a popular
+/// matching is a matching in it which matches every applicant and every
+/// f-post (Abraham, Irving, Kavitha and Mehlhorn)
+/// an edit only changes f and s for the applicants listing a post which
+/// becomes or stops being an f-post, these are unmatched and matched again
+/// through augmenting paths in the reduced graph, where every applicant has
+/// at most two edges, so the cost of an edit is proportional to the part of
+/// the reduced graph it touches rather than to the size of the instance
+class DynamicPopular {
+public:
+    typedef std::vector<IndexType> IndexListType;
+
+    struct Statistics {
+        unsigned long edits;            // calls to set_preferences and remove_applicant
+        unsigned long augmentations;    // augmenting paths found
+        unsigned long promotions;       // applicants moved from s(a) to f(a)
+        unsigned long visited;          // applicants visited looking for paths
+    };
+
+private:
+    std::vector<VertexPtr> B_;
+    std::map<IdType, IndexType> B_indices_;
+
+    // applicants are kept in slots which are not reused after a removal
+    std::vector<VertexPtr> A_;
+    std::map<IdType, IndexType> A_indices_;
+    std::vector<IndexListType> pref_lists_;     // posts in the order of preference
+
+    std::vector<std::set<IndexType>> f_applicants_; // applicants with f(a) = p
+    std::vector<std::set<IndexType>> listed_by_;    // applicants with p on their lists
+    IndexListType s_;                               // s(a) of every applicant
+
+    IndexListType A_mate_;          // post matched to an applicant (or the last resort)
+    IndexListType B_mate_;          // applicant matched to a post
+    std::set<IndexType> free_;      // applicants not matched in the reduced graph
+    std::set<IndexType> pending_;   // f-posts which may be unmatched
+
+    // search state of augment(), marked with the number of the search
+    std::vector<unsigned long> seen_;
+    IndexListType parent_;
+    unsigned long nsearches_;
+
+    Statistics stats_;
+
+    bool is_f_post(IndexType p) const;
+
+    // the most preferred post of a which is not an f-post, or the last resort
+    IndexType find_s_post(IndexType a) const;
+
+    // free the post matched to a and add a to the free applicants
+    void unmatch(IndexType a);
+
+    // p has become or is no longer an f-post
+    void f_post_added(IndexType p);
+    void f_post_removed(IndexType p);
+
+    // remove a from the reduced graph, and add it with the given list
+    void detach(IndexType a);
+    void attach(IndexType a, const IndexListType& pref_list);
+
+    // look for an augmenting path from the free applicant a
+    bool augment(IndexType a);
+
+    // match the free applicants and the unmatched f-posts where possible
+    void repair();
+
+public:
+    /// the applicants and posts of G with the preferences of the applicants,
+    /// throws if G is not a strict house allocation instance with unit quotas
+    DynamicPopular(const BipartiteGraph& G);
+    virtual ~DynamicPopular();
+
+    /// are the preferences of A strict and is every quota one
+    static bool is_applicable(const BipartiteGraph& G);
+
+    /// replace the preference list of the applicant with the given id, which
+    /// is added if it does not exist, returns true if a popular matching
+    /// exists after the edit, throws if a post is unknown or listed twice
+    bool set_preferences(const IdType& a, const std::vector<IdType>& pref_list);
+
+    /// remove the applicant with the given id, returns true if a popular
+    /// matching exists after the edit, throws if there is no such applicant
+    bool remove_applicant(const IdType& a);
+
+    /// does a popular matching exist for the current preferences
+    bool has_popular_matching() const;
+
+    /// the popular matching, if it exists, applicants matched to their last
+    /// resort posts are left unmatched
+    MatchedPairListType get_matched_pairs() const;
+
+    /// write the matching as print_matching() does, ordered by applicant ids
+    void write_matching(std::ostream& out) const;
+
+    const Statistics& get_statistics() const;
+};
+
+std::ostream& operator<<(std::ostream& out, const DynamicPopular::Statistics& stats);
+
+#endif
@@ -1,45 +1,144 @@
 #ifndef FLOWNETWORK_H
 #define FLOWNETWORK_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "Edge.h"
 #include "TDefs.h"
 
-// Flow network with capacities between edges.  
+// Flow network with capacities between edges.
+// The edges are kept as parallel arrays indexed by edge id, edges_[e] and
+// edges_[e ^ 1] are in opposite directions so the tail of e is the head of
+// e ^ 1, and the adjacency of every node is a compressed range of edge ids
+// which is rebuilt before a traversal only if edges were added since.
 class FlowNetwork {
 public:
 	typedef std::vector<Edge> EdgeList;
 
+	// Algorithms for the maximum flow, AUTO chooses push-relabel when the
+	// shortest augmenting path is longer than AUTO_DEPTH and Dinic otherwise
+	enum MaxFlowAlgorithm { DINIC, PUSH_RELABEL, AUTO };
+	static const NodeType AUTO_DEPTH = 12;
+
+	// How decompose_nodes_STU finds the S and T nodes, INCREMENTAL repairs
+	// the previous search trees from the edges changed since, and VERIFY
+	// also redoes the full search and throws if the two differ
+	enum DecompositionMode { FULL, INCREMENTAL, VERIFY };
+
 private:
+	static MaxFlowAlgorithm default_algorithm_;     // algorithm used when none is given
+	static DecompositionMode decomposition_mode_;   // how the S and T nodes are found
+
 	NodeType num_nodes_;                            // number of nodes in the network
-	EdgeList edges_;                                // the list of edges (both forward and reverse edges)
-	std::vector<std::vector<NodeType> > adj_list_;  // the adjacency list of the network graph 
+	std::vector<NodePtr> nodes_;                    // the node with a given id, for the labels and the edges returned
+	std::vector<NodeType> heads_;                   // head of every edge (both forward and reverse edges)
+	std::vector<FlowType> capacities_;              // capacity of every edge
+	std::vector<FlowType> flows_;                   // flow through every edge
+	std::vector<RankType> ranks_;                   // rank of every edge in the original graph
+	std::vector<NodeType> adj_offsets_;             // edges leaving node u are adj_edges_[adj_offsets_[u], adj_offsets_[u+1])
+	std::vector<NodeType> adj_edges_;               // edge ids grouped by their tails, in the order they were added
+	bool adj_valid_;                                // does the adjacency include every edge
 	std::vector<NodeType> dist_;                    // list to store distances for use in traversal across graph
+	std::vector<NodeType> bfs_order_;               // nodes in the order they were reached by path_between
+	std::vector<char> in_frontier_;                 // is a node in the level expanded bottom up by level_bfs
+	std::unique_ptr<std::atomic<std::uint64_t>[]> visited_; // bitmap of the nodes reached by level_bfs, cleared before it returns
+	std::vector<std::vector<NodeType>> bfs_found_;  // nodes reached by every block of a level of level_bfs
+	std::vector<FlowType> lower_inflows_;           // lower bounds of the edges into a node minus those out of it
+	std::vector<CostType> potentials_;              // node potentials making the reduced costs non-negative
+	std::vector<CostType> cost_dist_;               // reduced cost of the shortest path from the source
+	std::vector<NodeType> pred_edges_;              // last edge on that path
+	std::vector<NodeType> reached_;                 // nodes whose cost_dist_ was set by the last search
 	std::vector<NodeType> path_to_traverse_;        // list to store the next vertex from which path is to be traversed
+	std::vector<NodeType> path_edges_;              // edges on the path of the depth first search in send_flow
+	std::vector<FlowType> path_limits_;             // least residual capacity along every prefix of that path
+	std::vector<FlowType> excess_;                  // excess of every node in a preflow
+	std::vector<NodeType> heights_;                 // labels of the nodes in push-relabel
+	std::vector<NodeType> height_counts_;           // number of nodes with a given label below num_nodes_
+	std::vector<Node::DecompositionLabel> labels_;  // decomposition label of every node
+	std::vector<NodeType> changed_nodes_;           // nodes whose labels changed since the last deletion
+	std::vector<NodeType> relabelled_nodes_;        // nodes whose labels changed in the last decomposition
+	NodeType checked_edges_;                        // edges added before this were looked at by the last deletion
+	std::vector<NodeType> S_parents_;               // residual edge through which a node was reached from the source
+	std::vector<NodeType> T_parents_;               // residual edge through which a node reaches the sink
+	std::vector<NodeType> S_order_;                 // nodes reachable from the source, parents first
+	std::vector<NodeType> T_order_;                 // nodes which can reach the sink, parents first
+	std::vector<char> touched_;                     // has the edge pair changed since the last decomposition
+	std::vector<NodeType> touched_edges_;           // the edge pairs (edge id / 2) which changed
+	NodeType decomposed_source_;                    // source and sink of the last decomposition
+	NodeType decomposed_sink_;
+
+	// Rebuilds the adjacency of the nodes if edges were added
+	void build_adjacency();
 
 	// Returns if there is a path from source to sink by performing a breadth first search
 	// Also sets the distance from source to all nodes
 	bool path_between(NodeType source, NodeType sink);
 
-	// Sends flow through a path from source to sink computing using depth first search
-	// Returns the flow pushed through the path
-	FlowType send_flow(NodeType source, NodeType sink, FlowType flow = -1);
+	// Sets dist to the distance of every node from root in the residual
+	// network (to root if reverse), num_nodes_ + 1 if it is not reachable,
+	// and order to the nodes reached in the order of their distances
+	// The search stops after the level of target if target is not -1
+	// Every level is expanded by several threads, top down from the nodes
+	// of the level or bottom up from the nodes not reached yet, the
+	// distances do not depend on the number of threads
+	void level_bfs(NodeType root, NodeType target, bool reverse,
+				   std::vector<NodeType>& dist, std::vector<NodeType>& order);
+
+	// Dinic's algorithm, the distances of the first phase have been computed
+	// Returns the flow added
+	FlowType dinic(NodeType source, NodeType sink);
+
+	// FIFO push-relabel with global relabeling and the gap heuristic, the
+	// preflow is then turned into a flow by returning the excess to source
+	// Returns the flow added
+	FlowType push_relabel(NodeType source, NodeType sink);
 
-	// Finds the S nodes and sets their decomposition labels to 'S'
-	void find_S_nodes(NodePtr source);
+	// Sets the labels to the distances to target in the residual network,
+	// nodes which cannot reach target (and other) get num_nodes_
+	void global_relabel(NodeType target, NodeType other);
 
-	// Finds the S nodes and sets their decomposition labels to 'S'
-	void find_T_nodes(NodePtr sink);
+	// Pushes the excess of every node other than target and other towards
+	// target, nodes labelled num_nodes_ or more are left alone if use_gap
+	void discharge_all(NodeType target, NodeType other, bool use_gap);
+
+	// Sends a blocking flow from source to sink through the bfs tree using an
+	// iterative depth first search, each path found is augmented at once
+	// Returns the flow pushed through all the paths
+	FlowType send_flow(NodeType source, NodeType sink);
+
+	// Records that the capacity or the flow of an edge changed
+	void touch_edge(NodeType edge_id);
+
+	// Updates the tree of the nodes reachable from root in the residual
+	// network (or which can reach root if reverse), a full search is done
+	// if full and otherwise only the nodes cut off by an edge which lost its
+	// residual capacity and those behind a touched edge are looked at
+	void update_tree(NodeType root, bool reverse, std::vector<NodeType>& parents,
+					 std::vector<NodeType>& order, bool full);
 	
-	// Returns whether the edge (u, v) has the decompostion labels
-	// of decomposition_label_u and decomposition_label_v respectively
-	bool is_edge_label(Edge& edge, IdType decomposition_label_u,
-					   IdType decomposition_label_v);
+	// Deletes the edge (u, v) and its reverse if u is a T or U node and v
+	// is an S node
+	void delete_if_into_S(NodeType edge_id);
 	
 	// Returns whether the edge (u, v) is a residual edge
-	bool is_residual_edge(Edge& edge, Edge& other_edge);
+	bool is_residual_edge(NodeType edge_id) const;
+
+	// Returns the cost of an edge, its rank, or minus the rank of the
+	// forward edge for a reverse edge
+	CostType get_cost(NodeType edge_id) const;
+
+	// Sets the potentials to the costs of the shortest residual paths from
+	// source with Bellman-Ford if a residual edge has a negative cost
+	void init_potentials(NodeType source);
+
+	// Finds a shortest path from source to sink in the residual network by
+	// Dijkstra's algorithm on the reduced costs, and updates the potentials
+	// so the reduced costs stay non-negative, returns false if there is none
+	bool shortest_path(NodeType source, NodeType sink);
 	
 public:
 	FlowNetwork();
@@ -51,23 +150,92 @@ public:
 	
 	// Adds an edge to the flow network
 	void add_edge(NodePtr U, NodePtr V, FlowType capacity, RankType rank); 
+
+	// Adds an edge between the nodes with the given ids, which need not
+	// have a Node, get_tail_node and get_head_node return null for them
+	// Returns the id of the edge, -1 if u and v are the same
+	NodeType add_edge(NodeType u, NodeType v, FlowType capacity, RankType rank);
+
+	// Adds an edge whose flow has to be between lower and capacity, the
+	// edge is kept with capacity - lower and the lower bound is routed by
+	// compute_feasible_circulation
+	void add_edge(NodePtr U, NodePtr V, FlowType lower, FlowType capacity, RankType rank);
 	
-	// Deletes all edges which have the decomposition labels from
-	// decomposition_label_u to decomposition_label_v, for instance T->S edges
-	void delete_edges(IdType decomposition_label_u, IdType decomposition_label_v);
+	// Deletes all edges from T and U nodes to S nodes, only the edges added
+	// since the last call and those of nodes whose labels changed since then
+	// are looked at, the others were deleted already if needed
+	void delete_edges_into_S();
 
-	// Computes the maximum flow from the source to sink in the flow network
-	// Uses Dinic's Algorithm
+	// Computes the maximum flow from the source to sink in the flow network,
+	// starting from the current flow, and returns the flow added
+	// Uses Dinic's Algorithm or push-relabel, the S, T and U nodes found by
+	// decompose_nodes_STU do not depend on the algorithm
 	// Code for MaxFlow is based on Stanford ACM ICPC Notebook 2015-16
 	// with appropriate modifications for use in this library
 	FlowType compute_max_flow(NodePtr source, NodePtr sink);
+	FlowType compute_max_flow(NodePtr source, NodePtr sink, MaxFlowAlgorithm algorithm);
+
+	// Computes a maximum flow of minimum cost from source to sink, the cost
+	// of an edge being its rank, by successive shortest paths, and returns
+	// the flow added and adds its cost to cost
+	// The current flow must be of minimum cost for its value (no residual
+	// cycle has a negative cost), which holds for the zero flow
+	FlowType compute_min_cost_flow(NodePtr source, NodePtr sink, CostType& cost);
+
+	// Looks for a circulation meeting the lower bounds of the edges (add an
+	// edge from the sink to the source to look for a flow) by the reduction
+	// to a maximum flow from super_source, with an edge to every node with
+	// more lower bound flow in than out, to super_sink, with an edge from
+	// every node with more out than in, the two nodes must have no edges
+	// Returns the lower bound flow which cannot be routed, 0 if there is a
+	// feasible circulation, if not decompose_nodes_STU(super_source,
+	// super_sink) labels T the sink side of the minimum cut closest to
+	// super_sink
+	FlowType compute_feasible_circulation(NodePtr super_source, NodePtr super_sink);
+
+	// The algorithm used by compute_max_flow when none is given, AUTO by default
+	static void set_default_algorithm(MaxFlowAlgorithm algorithm);
+	static MaxFlowAlgorithm get_default_algorithm();
+
+	// The way decompose_nodes_STU finds the labels, INCREMENTAL by default
+	static void set_decomposition_mode(DecompositionMode mode);
+	static DecompositionMode get_decomposition_mode();
 	
-	// Decomposes the nodes in the flow network into S, T and U nodes
+	// Decomposes the nodes in the flow network into S, T and U nodes, every
+	// node not reachable from source or sink in the residual network is U
 	void decompose_nodes_STU(NodePtr source, NodePtr sink);
 	
 	// Returns the residual edges of the residual network corresponding to
 	// the flow through the network
 	void get_residual_edges(EdgeList& residual_edges, EdgeList& reverse_edges);	
+
+	// Calls visit(edge_id) for every residual edge in the order of the edge
+	// ids without copying the edges, the reverse of an edge is edge_id ^ 1
+	template <typename Visitor>
+	void for_each_residual_arc(Visitor visit) const {
+		for (NodeType edge_id = 0; edge_id < (NodeType) heads_.size(); ++edge_id) {
+			if (is_residual_edge(edge_id)) {
+				visit(edge_id);
+			}
+		}
+	}
+
+	// The tail and the head of an edge given by its id
+	NodeType get_tail(NodeType edge_id) const { return heads_[edge_id ^ 1]; }
+	NodeType get_head(NodeType edge_id) const { return heads_[edge_id]; }
+
+	// The nodes and the rank of an edge given by its id
+	const NodePtr& get_tail_node(NodeType edge_id) const { return nodes_[get_tail(edge_id)]; }
+	const NodePtr& get_head_node(NodeType edge_id) const { return nodes_[heads_[edge_id]]; }
+	RankType get_rank(NodeType edge_id) const { return ranks_[edge_id]; }
+	FlowType get_flow(NodeType edge_id) const { return flows_[edge_id]; }
+
+	// The label given to a node by the last decomposition
+	Node::DecompositionLabel get_label(NodeType node) const { return labels_[node]; }
+
+	// The nodes whose labels were changed by the last decomposition, every
+	// label is U before the first one
+	const std::vector<NodeType>& get_relabelled_nodes() const { return relabelled_nodes_; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef GRAPH_INDEX_H
+#define GRAPH_INDEX_H
+
+#include <vector>
+#include "BipartiteGraph.h"
+#include "TDefs.h"
+
+// Dense, array based view of a bipartite graph.
+// A vertex is identified by its index in its partition (Vertex::get_index())
+// and the edges are numbered in the order in which they appear on the
+// preference lists of the vertices in partition A, so that the edges
+// incident to a vertex a are [A_offset(a), A_offset(a+1)).
+class GraphIndex {
+public:
+    typedef std::vector<IndexType> IndexListType;
+    typedef std::vector<RankType> RankListType;
+
+    /// rank stored for an edge whose endpoint in B does not rank the other
+    static const RankType UNRANKED = 0;
+
+private:
+    const BipartiteGraph& G_;
+    IndexListType A_offsets_;   // edges of a are [A_offsets_[a], A_offsets_[a+1])
+    IndexListType B_offsets_;   // edges of b are B_edges_[B_offsets_[b] .. B_offsets_[b+1])
+    IndexListType B_edges_;     // edges grouped by their endpoint in B
+    IndexListType tails_;       // endpoint in A of every edge
+    IndexListType heads_;       // endpoint in B of every edge
+    RankListType A_ranks_;      // rank of the head on the preference list of the tail
+    RankListType B_ranks_;      // rank of the tail on the preference list of the head
+    IndexListType A_quotas_;    // upper quota of the vertices in A
+    IndexListType B_quotas_;    // upper quota of the vertices in B
+
+public:
+    GraphIndex(const BipartiteGraph& G);
+    virtual ~GraphIndex();
+
+    const BipartiteGraph& get_graph() const;
+
+    IndexType num_A_vertices() const { return A_quotas_.size(); }
+    IndexType num_B_vertices() const { return B_quotas_.size(); }
+    IndexType num_edges() const { return heads_.size(); }
+
+    /// edges incident to a vertex in A are [A_begin(a), A_end(a))
+    IndexType A_begin(IndexType a) const { return A_offsets_[a]; }
+    IndexType A_end(IndexType a) const { return A_offsets_[a+1]; }
+
+    /// edges incident to a vertex in B are B_edge(i) for i in [B_begin(b), B_end(b))
+    IndexType B_begin(IndexType b) const { return B_offsets_[b]; }
+    IndexType B_end(IndexType b) const { return B_offsets_[b+1]; }
+    IndexType B_edge(IndexType i) const { return B_edges_[i]; }
+
+    IndexType get_tail(IndexType e) const { return tails_[e]; }
+    IndexType get_head(IndexType e) const { return heads_[e]; }
+    RankType get_A_rank(IndexType e) const { return A_ranks_[e]; }
+    RankType get_B_rank(IndexType e) const { return B_ranks_[e]; }
+    IndexType get_A_quota(IndexType a) const { return A_quotas_[a]; }
+    IndexType get_B_quota(IndexType b) const { return B_quotas_[b]; }
+
+    /// is v a vertex of partition A (resp. B) of this graph
+    bool is_A_vertex(const VertexPtr& v) const;
+    bool is_B_vertex(const VertexPtr& v) const;
+
+    /// the edge (a, b), or num_edges() if a and b are not adjacent
+    IndexType find_edge(IndexType a, IndexType b) const;
+};
+
+#endif
@@ -2,11 +2,12 @@
 #define HHEURISTIC_HRLQ_H
 
 #include "MatchingAlgorithm.h"
+#include "ReducedGraphCache.h"
 
 class HHeuristicHRLQ : public MatchingAlgorithm {
 private:
-    // graph for phase 2
-    std::unique_ptr<BipartiteGraph> G2_;
+    // graph for phase 2, shared through the cache of reduced graphs of G
+    ReducedGraphCache::GraphPtr G2_;
 
     // matching to hold temporary results
     MatchedPairListType M_tmp_;
@@ -14,8 +15,8 @@ private:
     bool compute_phase2_matching(const MatchedPairListType& M,
                                  std::map<IdType, int>& def,
                                  int s);
-    // augment graph phase 2
-    std::unique_ptr<BipartiteGraph> augment_phase2(const MatchedPairListType& M, int s);
+    // augment graph phase 2, this depends only on G and s
+    std::unique_ptr<BipartiteGraph> augment_phase2(int s);
 
 public:
     HHeuristicHRLQ(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
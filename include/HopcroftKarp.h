@@ -0,0 +1,89 @@
+#ifndef HOPCROFT_KARP_H
+#define HOPCROFT_KARP_H
+
+#include <vector>
+#include "GraphIndex.h"
+#include "TDefs.h"
+
+// Capacitated Hopcroft-Karp on the dense view of a bipartite graph.
+// Every vertex may be matched to as many partners as its upper quota and
+// every edge may be used at most once. Each phase finds a maximal set of
+// shortest augmenting paths using a layered BFS followed by a DFS that
+// remembers the current arc of every vertex, hence a maximum matching is
+// computed in O(sqrt(n) m) time.
+class HopcroftKarp {
+public:
+    typedef std::vector<IndexType> IndexListType;
+    typedef std::vector<IndexType>::size_type SizeType;
+
+    /// an augmenting path a_0, b_0, a_1, b_1, ..., a_k, b_k where the
+    /// edges (a_i, b_i) are unmatched and (b_i, a_i+1) are matched
+    typedef std::vector<VertexPtr> PathType;
+    typedef std::vector<PathType> PathListType;
+
+    /// result of checking a matching for augmenting paths
+    struct Result {
+        bool is_maximum;            // there is no augmenting path
+        SizeType cardinality;       // size of the matching checked
+        SizeType max_cardinality;   // size of a maximum matching
+        PathListType paths;         // shortest augmenting paths which can be
+                                    // applied simultaneously (if asked for)
+    };
+
+private:
+    static const IndexType INFINITE_LEVEL;
+
+    GraphIndex index_;
+    std::vector<bool> matched_;     // is the edge in the matching
+    IndexListType A_residual_;      // remaining capacity of vertices in A
+    IndexListType B_residual_;      // remaining capacity of vertices in B
+    IndexListType A_level_;         // layer of a vertex in A in the current phase
+    IndexListType B_level_;         // layer of a vertex in B in the current phase
+    std::vector<bool> A_visited_;   // visited sets for the layered BFS
+    std::vector<bool> B_visited_;
+    IndexListType A_arc_;           // current arc of vertices in A
+    IndexListType B_arc_;           // current arc of vertices in B
+    IndexListType path_;            // edges on the path explored by the DFS
+    IndexType sink_level_;          // level of the shortest augmenting paths
+    SizeType cardinality_;          // size of the current matching
+
+    // build the layered graph, returns true if there is an augmenting path
+    bool build_layers();
+
+    // find and apply an augmenting path starting at a (in the layered graph)
+    bool augment_from(IndexType a, PathListType* paths);
+
+    // run one phase of the algorithm, returns the number of augmentations
+    SizeType augment_phase(PathListType* paths);
+
+public:
+    HopcroftKarp(const BipartiteGraph& G);
+    virtual ~HopcroftKarp();
+
+    const GraphIndex& get_index() const;
+
+    /// start from the given matching, edges not in the graph are ignored
+    void set_matching(const MatchedPairListType& M);
+
+    /// augment the current matching to a maximum matching, returns its size
+    SizeType compute_maximum();
+
+    /// size of the current matching
+    SizeType get_cardinality() const;
+
+    /// is the edge e in the current matching
+    bool is_matched(IndexType e) const;
+
+    /// is M a maximum matching, what is the size of a maximum matching and
+    /// optionally a set of augmenting paths with respect to M
+    Result check(const MatchedPairListType& M, bool find_paths = false);
+
+    /// is there an augmenting path with respect to M, this is a single BFS
+    bool has_augmenting_path(const MatchedPairListType& M);
+
+    /// add the current matching to M, partners are ranked as in the graph
+    /// (vertices in B which do not rank their partner use the rank 1)
+    void get_matched_pairs(MatchedPairListType& M) const;
+};
+
+#endif
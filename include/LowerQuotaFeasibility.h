@@ -0,0 +1,37 @@
+#ifndef LOWER_QUOTA_FEASIBILITY_H
+#define LOWER_QUOTA_FEASIBILITY_H
+
+#include <vector>
+#include "BipartiteGraph.h"
+#include "TDefs.h"
+
+/// does a matching exist in which every vertex has at least as many
+/// partners as its lower quota (and at most its upper quota), found as a
+/// feasible circulation on the network source -> A -> B -> sink -> source,
+/// where the quotas bound the flow on the edges from the source and to the
+/// sink, with one maximum flow
+/// if there is none, the vertices of B on the sink side of the minimum cut
+/// closest to the sink form a deficient set: their lower quotas add up to
+/// more than the partners they can get together, by the deficiency
+class LowerQuotaFeasibility {
+private:
+    FlowType deficiency_;                   // lower quota which cannot be met
+    std::vector<VertexPtr> deficient_set_;  // vertices of B in the cut, in index order
+
+public:
+    LowerQuotaFeasibility(const BipartiteGraph& G);
+    virtual ~LowerQuotaFeasibility();
+
+    /// can every lower quota be met
+    bool is_feasible() const;
+
+    /// by how much the lower quotas of the deficient set cannot be met, 0
+    /// if the quotas can be met
+    FlowType get_deficiency() const;
+
+    /// the smallest set of vertices in B with the largest deficiency, empty
+    /// if the quotas can be met
+    const std::vector<VertexPtr>& get_deficient_set() const;
+};
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef MATCHING_ALGORITHM_H
 #define MATCHING_ALGORITHM_H
 
+#include <ostream>
 #include "BipartiteGraph.h"
+#include "PopularityWitness.h"
 
 class MatchingAlgorithm {
 protected:
@@ -11,6 +13,8 @@ private:
     const std::unique_ptr<BipartiteGraph>& G_;
 
 protected:
+    // maps a matching in a reduced graph to the graph G_ using the origins
+    // recorded by the reduction, O(|M|) in total
     MatchedPairListType& map_inverse(const MatchedPairListType& M);
 
 public:
@@ -19,6 +23,14 @@ public:
     virtual bool compute_matching() = 0;
     virtual MatchedPairListType& get_matched_pairs();
     const std::unique_ptr<BipartiteGraph>& get_graph() const;
+
+    /// a witness for the popularity of the matching computed (on the
+    /// original graph), returns false if the algorithm cannot provide one
+    virtual bool get_witness(PopularityWitness& witness);
+
+    /// writes statistics about the computation as lines "name,value",
+    /// nothing by default
+    virtual void write_statistics(std::ostream& out) const;
     bool is_feasible(const std::unique_ptr<BipartiteGraph>& G,
                      const MatchedPairListType& M);
 };
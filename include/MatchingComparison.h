@@ -0,0 +1,91 @@
+#ifndef MATCHING_COMPARISON_H
+#define MATCHING_COMPARISON_H
+
+#include <string>
+#include <vector>
+#include "GraphIndex.h"
+#include "PopularityWitness.h"
+#include "TDefs.h"
+
+// Compares matchings in a graph by the votes of its vertices.
+// A vertex compares its partners in M and M' after removing the partners
+// common to both, the remaining partners are sorted by rank and compared
+// position by position (a missing partner is worse than any partner).
+// Every position where M is better counts as a vote for M and vice versa,
+// for a vertex with unit quota this is the usual vote. Vertices in B with
+// an empty preference list do not vote, and none of them votes when the
+// comparison is one-sided (the popularity of the matchings of CPM).
+class MatchingComparison {
+public:
+    typedef GraphIndex::IndexListType IndexListType;
+    typedef std::vector<char> EdgeSetType;
+
+    /// votes cast when comparing two matchings
+    struct VoteCount {
+        unsigned long first;    // votes for the first matching
+        unsigned long second;   // votes for the second matching
+
+        long margin() const { return (long) first - (long) second; }
+    };
+
+    /// the unpopularity factor as a fraction num/den, den is 0 if the
+    /// factor is unbounded
+    struct Factor {
+        unsigned long num;
+        unsigned long den;
+
+        bool is_unbounded() const { return den == 0; }
+        double value() const { return (double) num / den; }
+    };
+
+private:
+    GraphIndex index_;
+    std::vector<char> B_votes_;     // does a vertex in B vote
+
+    // the rank of the head on the list of the tail (resp. tail on the list
+    // of the head), partners missing from a list are ranked after the list
+    RankType get_A_rank(IndexType e) const;
+    RankType get_B_rank(IndexType e) const;
+
+    // vote of a single vertex given the ranks of its partners in exactly
+    // one of the matchings, returns the votes for the first and second
+    void vote(std::vector<RankType>& first, std::vector<RankType>& second,
+              VoteCount& count) const;
+
+    // maximum weight of a matching with the given edge weights, using
+    // successive shortest paths with Dijkstra and potentials, the edges of
+    // the matching are stored in M
+    long max_weight_matching(const std::vector<long>& weights, EdgeSetType& M) const;
+
+    // the maximum of q * votes(M', M) - p * votes(M, M') over all matchings
+    // M', and a matching M' achieving it
+    VoteCount max_ratio_matching(const EdgeSetType& M, unsigned long p, unsigned long q,
+                                 EdgeSetType& M_other) const;
+
+public:
+    /// if one_sided only the vertices of A vote
+    MatchingComparison(const BipartiteGraph& G, bool one_sided = false);
+    virtual ~MatchingComparison();
+
+    const GraphIndex& get_index() const;
+
+    /// the edges of M in this graph, throws if M is not a subset of edges
+    EdgeSetType get_edge_set(const MatchedPairListType& M) const;
+
+    /// count the votes comparing M1 with M2, O(m) in total
+    VoteCount compare(const EdgeSetType& M1, const EdgeSetType& M2) const;
+    VoteCount compare(const MatchedPairListType& M1, const MatchedPairListType& M2) const;
+
+    /// the unpopularity factor max_{M'} votes(M', M) / votes(M, M')
+    /// computed with Dinkelbach's method on maximum weight matchings,
+    /// throws if a vertex which votes has an upper quota larger than one
+    Factor unpopularity_factor(const MatchedPairListType& M) const;
+
+    /// does the witness certify that M is popular, this takes O(m) time
+    /// (the edges are checked in parallel), on failure error describes the
+    /// violated constraint
+    bool verify_witness(const MatchedPairListType& M, const PopularityWitness& witness,
+                        std::string& error) const;
+};
+
+#endif
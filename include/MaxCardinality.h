@@ -0,0 +1,25 @@
+#ifndef MAX_CARDINALITY_H
+#define MAX_CARDINALITY_H
+
+#include "MatchingAlgorithm.h"
+#include "GraphIndex.h"
+
+/// a maximum cardinality matching, preferences are only used to rank the
+/// partners in the matching returned
+class MaxCardinality : public MatchingAlgorithm {
+private:
+    // Hopcroft-Karp when every vertex has an upper quota of at most one
+    void compute_unit_matching(const GraphIndex& index);
+
+    // max flow on the network source -> A -> B -> sink otherwise, with the
+    // quotas as capacities on the edges from the source and to the sink
+    void compute_flow_matching(const GraphIndex& index);
+
+public:
+    MaxCardinality(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
+    virtual ~MaxCardinality();
+
+    bool compute_matching();
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <sstream>
+#include <string>
+#include "Statistics.h"
+
+// Rows of Statistics::Metrics appended to a file, one row per matching.
+// The rows are kept in memory and appended to the file by flush() (or when
+// the writer is destroyed), so that a batch of runs writes the file once.
+// A CSV file starts with a header if it was empty, the lists of a row are
+// separated by spaces (the hospitals as id:count), a JSON file has one
+// object per line.
+class MetricsWriter {
+public:
+    enum Format { CSV, JSON };
+
+private:
+    std::string path_;
+    Format format_;
+    std::string instance_;      // name of the instance of the next rows
+    std::ostringstream rows_;   // rows not appended yet
+
+    void write_csv(const Statistics::Metrics& metrics);
+    void write_json(const Statistics::Metrics& metrics);
+
+public:
+    /// the format is given by the extension of path, JSON for .json and
+    /// .jsonl and CSV otherwise
+    MetricsWriter(const std::string& path);
+    MetricsWriter(const std::string& path, Format format);
+    virtual ~MetricsWriter();
+
+    /// name of the instance recorded with the next rows
+    void set_instance(const std::string& instance);
+
+    /// add a row for the given metrics
+    void write(const Statistics::Metrics& metrics);
+
+    /// append the rows to the file
+    void flush();
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MIN_RANK_SUM_H
+#define MIN_RANK_SUM_H
+
+#include "MatchingAlgorithm.h"
+
+/// a maximum cardinality matching in which the sum of the ranks of the
+/// partners of the vertices in A is the least possible, found as a minimum
+/// cost maximum flow on the network source -> A -> B -> sink, where the
+/// edge (a, b) costs the rank of b on the list of a and the quotas are the
+/// capacities of the edges from the source and to the sink
+class MinRankSum : public MatchingAlgorithm {
+private:
+    CostType rank_sum_;     // sum of the ranks in the matching computed
+
+public:
+    MinRankSum(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
+    virtual ~MinRankSum();
+
+    bool compute_matching();
+
+    /// sum of the ranks of the partners of the vertices in A
+    CostType get_rank_sum() const;
+};
+
+#endif
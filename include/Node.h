@@ -5,19 +5,36 @@
 
 // Node in a flow network.
 class Node {
+public:
+	// Decomposition label of a node with respect to a maximum flow
+	enum DecompositionLabel : char { LABEL_S = 'S', LABEL_T = 'T', LABEL_U = 'U' };
+
+	// Role of a node in a network of classification trees, the root of an
+	// applicant (C_*_a) or of a post (C_*_p), and the leaves C_p_a of an
+	// applicant and C_a_p of a post, those of a last resort post are kept
+	// apart as they are not part of the matching
+	enum NodeRole : char {
+		ROLE_NONE, ROLE_SOURCE, ROLE_SINK,
+		ROLE_APPLICANT_ROOT, ROLE_POST_ROOT, ROLE_LAST_RESORT_ROOT,
+		ROLE_APPLICANT_LEAF, ROLE_POST_LEAF, ROLE_LAST_RESORT_LEAF
+	};
+
 private:
-	IdType node_name_;            // name of the node (for instance, C_a_b)
-	NodeType node_id_;            // id of this node
-	IdType decomposition_label_;  // decomposition label for the node (S or T or U)
+	IdType node_name_;                        // name of the node (for instance, C_a_b)
+	NodeType node_id_;                        // id of this node
+	DecompositionLabel decomposition_label_;  // decomposition label for the node (S or T or U)
+	NodeRole role_;                           // role of the node, ROLE_NONE if not a classification tree
 
 public:
 	Node();
-	Node(IdType node_name, NodeType node_id);
+	Node(IdType node_name, NodeType node_id, NodeRole role = ROLE_NONE);
 	~Node();
 	const IdType& get_name() const;
 	const NodeType& get_id() const;
-	const IdType& get_decomposition_label() const;
-	void set_decomposition_label(IdType decomposition_label);
+	DecompositionLabel get_decomposition_label() const;
+	void set_decomposition_label(DecompositionLabel decomposition_label);
+	NodeRole get_role() const;
+	bool is_post_leaf() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,171 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TDefs.h"
+
+// minimum number of items handed to a thread, smaller ranges are not split
+static const IndexType PARALLEL_GRAIN_SIZE = 4096;
+
+// number of threads set by set_parallel_threads, 0 for every hardware thread
+inline unsigned& parallel_threads_limit() {
+    static unsigned nthreads = 0;
+    return nthreads;
+}
+
+/// use at most nthreads threads in parallel_for, or one per hardware thread
+/// if nthreads is 0 (the default), results do not depend on this
+inline void set_parallel_threads(unsigned nthreads) {
+    parallel_threads_limit() = nthreads;
+}
+
+/// number of blocks [0, n) is split into by parallel_for
+inline unsigned parallel_blocks(IndexType n) {
+    unsigned nthreads = parallel_threads_limit();
+    if (nthreads == 0) {
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return std::max(1u, std::min<unsigned>(nthreads, n / PARALLEL_GRAIN_SIZE));
+}
+
+// Threads kept for the whole run, started by the first parallel_for which
+// needs them, so that the levels of a breadth first search do not each pay
+// for creating and joining threads. The blocks of a call are handed out one
+// at a time to the workers and the calling thread, which returns once every
+// block is done. A parallel_for inside a block runs in the calling thread.
+class ParallelPool {
+public:
+    typedef std::function<void(unsigned)> TaskType;
+
+private:
+    std::mutex run_mutex_;              // one call at a time
+    std::mutex mutex_;                  // guards the state of the call
+    std::condition_variable work_cv_;   // a call started or the pool stops
+    std::condition_variable done_cv_;   // the last block of a call is done
+    std::vector<std::thread> workers_;
+    const TaskType* task_;              // task of the current call
+    unsigned nblocks_;                  // blocks of the current call
+    unsigned next_block_;               // next block to hand out
+    unsigned pending_;                  // blocks not done yet
+    unsigned long generation_;          // number of calls so far
+    bool stop_;
+
+    static bool& in_block() {
+        static thread_local bool running = false;
+        return running;
+    }
+
+    // run blocks of the current call until none is left, mutex_ is held
+    void run_blocks(std::unique_lock<std::mutex>& lock) {
+        while (next_block_ < nblocks_) {
+            unsigned block = next_block_++;
+            const TaskType& task = *task_;
+            lock.unlock();
+            in_block() = true;
+            task(block);
+            in_block() = false;
+            lock.lock();
+
+            if (--pending_ == 0) {
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+    void work() {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true) {
+            work_cv_.wait(lock, [&] { return stop_ or generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+
+            seen = generation_;
+            run_blocks(lock);
+        }
+    }
+
+public:
+    ParallelPool()
+        : task_(nullptr), nblocks_(0), next_block_(0), pending_(0),
+          generation_(0), stop_(false)
+    {}
+
+    ~ParallelPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        work_cv_.notify_all();
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    static ParallelPool& instance() {
+        static ParallelPool pool;
+        return pool;
+    }
+
+    /// call task(block) for every block in [0, nblocks)
+    void run(unsigned nblocks, const TaskType& task) {
+        if (in_block()) {
+            for (unsigned block = 0; block < nblocks; ++block) {
+                task(block);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        // the calling thread runs blocks too
+        while (workers_.size() + 1 < nblocks) {
+            workers_.emplace_back(&ParallelPool::work, this);
+        }
+
+        task_ = &task;
+        nblocks_ = nblocks;
+        next_block_ = 0;
+        pending_ = nblocks;
+        ++generation_;
+        work_cv_.notify_all();
+
+        run_blocks(lock);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        task_ = nullptr;
+    }
+};
+
+/// split [0, n) into parallel_blocks(n) contiguous blocks and call
+/// f(block, begin, end) for every block, the blocks run on the threads of
+/// ParallelPool, a range too small to be split runs in the calling thread
+/// results can be accumulated per block and combined by the caller
+template <typename Function>
+void parallel_for(IndexType n, Function f) {
+    unsigned nblocks = parallel_blocks(n);
+
+    if (nblocks == 1) {
+        f(0, 0, n);
+        return;
+    }
+
+    IndexType block_size = (n + nblocks - 1) / nblocks;
+
+    ParallelPool::instance().run(nblocks, [&] (unsigned block) {
+        IndexType begin = std::min(n, block * block_size);
+        IndexType end = std::min(n, begin + block_size);
+        f(block, begin, end);
+    });
+}
+
+#endif
@@ -2,10 +2,11 @@
 #define POPULAR_H
 
 #include "MatchingAlgorithm.h"
+#include "ReducedGraphCache.h"
 
 class SPopular : public MatchingAlgorithm {
 private:
-    std::unique_ptr<BipartiteGraph> G_;
+    ReducedGraphCache::GraphPtr G_;     // the s-reduced graph, shared through the cache of G
     MatchedPairListType M_tmp_;
     // how many s values to try
     int sbegin_;
@@ -19,6 +20,13 @@ public:
 
     bool compute_matching();
     MatchedPairListType& get_matched_pairs();
+
+    /// witness from the levels of the matched vertices, available for
+    /// s <= 2 and strict preferences: a pair matched at level 0 has alpha +1 on the seat of the
+    /// vertex from A and -1 on the other seat, at level 1 this is reversed,
+    /// there is no witness if a vertex from B matched at level 0 does not
+    /// vote (its preference list is empty)
+    bool get_witness(PopularityWitness& witness);
 };
 
 /// max-card popular matching in an HR instance
@@ -0,0 +1,49 @@
+#ifndef POPULARITY_WITNESS_H
+#define POPULARITY_WITNESS_H
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include "BipartiteGraph.h"
+#include "TDefs.h"
+
+// Dual certificate for the popularity of a matching M.
+// Every vertex u with upper quota q has q seats, each seat holds at most one
+// partner of u in M. The witness assigns a value alpha to every seat, the
+// seats of u which are not occupied share the same value. M is popular if
+// the sum of all the alphas is at most 0 and the alphas are a feasible
+// solution to the dual of the max weight matching LP in the graph whose
+// edge weights are the votes with respect to M (see
+// MatchingComparison::verify_witness()).
+class PopularityWitness {
+public:
+    typedef int AlphaType;
+    typedef std::map<VertexPtr, AlphaType> SeatListType;
+
+private:
+    std::map<VertexPtr, SeatListType> seats_;    // alpha of occupied seats
+    std::map<VertexPtr, AlphaType> free_seats_;  // alpha of the free seats
+
+public:
+    PopularityWitness();
+    virtual ~PopularityWitness();
+
+    /// alpha of the seat of u which holds the partner v
+    void set_alpha(const VertexPtr& u, const VertexPtr& v, AlphaType alpha);
+    AlphaType get_alpha(const VertexPtr& u, const VertexPtr& v) const;
+
+    /// alpha of the seats of u which are not occupied (0 by default)
+    void set_free_alpha(const VertexPtr& u, AlphaType alpha);
+    AlphaType get_free_alpha(const VertexPtr& u) const;
+
+    /// write the witness as lines of the form
+    /// A,a,b,alpha (alpha of the seat of a which holds b)
+    /// B,b,a,alpha (alpha of the seat of b which holds a)
+    /// A,a,,alpha  (alpha of the free seats of a, if not 0)
+    void write(const std::unique_ptr<BipartiteGraph>& G, std::ostream& out) const;
+
+    /// read a witness written by write(), the vertices are looked up in G
+    void read(const std::unique_ptr<BipartiteGraph>& G, std::istream& in);
+};
+
+#endif
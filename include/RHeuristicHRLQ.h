@@ -2,18 +2,19 @@
 #define RHEURISTIC_HRLQ_H
 
 #include "MatchingAlgorithm.h"
+#include "ReducedGraphCache.h"
 
 class RHeuristicHRLQ : public MatchingAlgorithm {
 private:
-    // graphs for phase 1 and 2
-    std::unique_ptr<BipartiteGraph> G1_;
+    // graphs for phase 1 and 2, the graph for phase 1 is shared through
+    // the cache of reduced graphs of G
+    ReducedGraphCache::GraphPtr G1_;
     std::unique_ptr<BipartiteGraph> G2_;
 
     // matching to hold temporary results
     MatchedPairListType M_tmp_;
 
-    // augment graph for phase 1 and phase 2
-    std::unique_ptr<BipartiteGraph> augment_phase1();
+    // augment graph for phase 2
     std::unique_ptr<BipartiteGraph> augment_phase2(MatchedPairListType& M);
 
 public:
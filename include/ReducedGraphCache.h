@@ -0,0 +1,79 @@
+#ifndef REDUCED_GRAPH_CACHE_H
+#define REDUCED_GRAPH_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "BipartiteGraph.h"
+
+// Reduced graphs built from a graph, owned by that graph.
+// A reduced graph is keyed by the name of the transformation and its
+// parameter (for instance the s of the s-reduction), and is built at most
+// once as long as it stays in the cache. The graphs handed out are shared
+// and must not be modified, algorithms keep their own state (proposal
+// indices, matchings) outside of the graph. When the estimated size of the
+// cached graphs exceeds the capacity the least recently used graphs are
+// dropped, a graph still held by an algorithm lives on until it is released.
+class ReducedGraphCache {
+public:
+    typedef std::shared_ptr<const std::unique_ptr<BipartiteGraph>> GraphPtr;
+    typedef std::function<std::unique_ptr<BipartiteGraph>()> BuilderType;
+    typedef std::pair<std::string, int> KeyType;
+
+    /// default capacity, 256 MiB
+    static const std::size_t DEFAULT_CAPACITY = 256u << 20;
+
+    struct Statistics {
+        unsigned long hits;         // graphs found in the cache
+        unsigned long misses;       // graphs which had to be built
+        unsigned long evictions;    // graphs dropped to stay within capacity
+        std::size_t nbytes;         // estimated size of the cached graphs
+        std::size_t ngraphs;        // number of cached graphs
+    };
+
+private:
+    struct Entry {
+        GraphPtr graph;
+        std::size_t nbytes;
+        std::list<KeyType>::iterator lru_it;
+    };
+
+    std::size_t capacity_;
+    std::map<KeyType, Entry> entries_;
+    std::list<KeyType> lru_;        // most recently used key first
+    Statistics stats_;
+
+    // drop least recently used graphs until the size is within capacity
+    void evict();
+
+public:
+    ReducedGraphCache(std::size_t capacity = DEFAULT_CAPACITY);
+    virtual ~ReducedGraphCache();
+
+    /// the graph for the given transformation and parameter, it is built
+    /// with build if it is not in the cache
+    GraphPtr get(const std::string& transformation, int parameter,
+                 const BuilderType& build);
+
+    /// change the capacity (in bytes), evicting graphs if required
+    void set_capacity(std::size_t capacity);
+    std::size_t get_capacity() const;
+
+    /// drop all the cached graphs, the statistics are kept
+    void clear();
+
+    const Statistics& get_statistics() const;
+
+    /// estimate of the memory used by the vertices and preference lists of G
+    static std::size_t estimate_size(const BipartiteGraph& G);
+};
+
+/// print the statistics in the format key,value one per line
+std::ostream& operator<<(std::ostream& out, const ReducedGraphCache::Statistics& stats);
+
+#endif
@@ -6,4 +6,9 @@
 std::unique_ptr<BipartiteGraph> augment_graph(
     const std::unique_ptr<BipartiteGraph>& G, int s);
 
+// the graph induced by the vertices in B with a positive lower quota and
+// their neighbours, the vertices in B have the capacities (0, lq)
+std::unique_ptr<BipartiteGraph> augment_lower_quota_graph(
+    const std::unique_ptr<BipartiteGraph>& G);
+
 #endif
@@ -1,26 +1,57 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include <utility>
+#include <vector>
 #include "BipartiteGraph.h"
+#include "GraphIndex.h"
 
 class Statistics {
 public:
-    //size of matching
-    unsigned long int S;
-    //number of blocking pairs
-    unsigned long int BPC;
-    //number of blocking residents
-    unsigned long int BR;
-    //number of residents matched to their rank 1 hospitals
-    unsigned long int R1;
-    //Deficiency of graph
-    unsigned long int def;
+    typedef std::vector<std::pair<IdType, unsigned long int>> HospitalCountListType;
+
+    //statistics of a matching with respect to the graph
+    struct Metrics {
+        //size of matching
+        unsigned long int S;
+        //number of blocking pairs
+        unsigned long int BPC;
+        //number of blocking residents
+        unsigned long int BR;
+        //number of residents matched to their rank 1 hospitals
+        unsigned long int R1;
+        //Deficiency of graph
+        unsigned long int def;
+        //sum of the lower quotas of the hospitals
+        unsigned long int sum_of_lower_quota;
+        //rank_profile[r-1] is the number of pairs where the hospital has
+        //rank r on the preference list of the resident
+        std::vector<unsigned long int> rank_profile;
+        //number of residents matched to every hospital
+        HospitalCountListType hospital_sizes;
+        //residents missing from the hospitals below their lower quotas
+        HospitalCountListType lower_quota_deficits;
+    };
+
+private:
+    //residents, hospitals and edges of the graph by their indices
+    GraphIndex index_;
+    //has the deficiency of the graph been computed
+    bool has_deficiency_;
+    unsigned long int def_;
+    unsigned long int sum_of_lower_quota_;
+
+    //the deficiency is the same for every stable matching of the graph
+    //(rural hospitals theorem), it is computed once from the resident
+    //proposing one, with ties broken by the order of the preference lists
+    void compute_deficiency();
 
 public:
-    Statistics();
+    Statistics(const BipartiteGraph& G);
     virtual ~Statistics();
-    std::unique_ptr<BipartiteGraph> get_duplicate_graph(const std::unique_ptr<BipartiteGraph>& G);
-    void get_statistics(const std::unique_ptr<BipartiteGraph>& G, MatchedPairListType& M);
+
+    //the statistics of M, computed when asked for
+    Metrics get_statistics(const MatchedPairListType& M);
 };
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef SWITCHING_GRAPH_H
+#define SWITCHING_GRAPH_H
+
+#include <functional>
+#include <vector>
+#include "GraphIndex.h"
+#include "TDefs.h"
+
+// Switching graph of a popular matching M in a house allocation instance
+// with strict preferences where every quota is one (McDermid and Irving,
+// Popular matchings: structure and algorithms).
+// Every applicant a with a non-empty preference list has a first choice
+// f(a), and s(a) is its most preferred post which is not the first choice
+// of any applicant, or its last resort post if there is no such post. M
+// matches a to f(a) or s(a), and the switching graph has an edge from M(a)
+// to the other of these two posts for every applicant a. A post has at most
+// one outgoing edge, so every component either has exactly one cycle or is
+// a tree directed towards its sink (an unmatched post). The popular
+// matchings are exactly those obtained from M by switching any subset of
+// the cycles and at most one path to the sink in every tree, which starts
+// at a post that is not a first choice.
+class SwitchingGraph {
+public:
+    typedef GraphIndex::IndexListType IndexListType;
+
+    /// cost of matching applicant a to post b at the given rank, b is a null
+    /// pointer for the last resort post of a which has rank |pref(a)| + 1
+    typedef std::function<long(const VertexPtr& a, const VertexPtr& b, RankType rank)> CostFunction;
+
+    /// called with every popular matching, the enumeration stops if this
+    /// returns false
+    typedef std::function<bool(const MatchedPairListType& M)> VisitorType;
+
+private:
+    GraphIndex index_;
+    IndexListType mate_;            // post matched to an applicant (last resort posts follow B)
+    IndexListType out_;             // head of the edge leaving a post, or none
+    IndexListType applicant_;       // applicant owning the edge leaving a post
+    std::vector<char> is_f_post_;   // is a post the first choice of an applicant
+
+    // the components with a cycle are given by a post on the cycle, and the
+    // tree components by their sink and the posts where a path may start
+    IndexListType cycles_;
+    IndexListType sinks_;
+    std::vector<IndexListType> starts_;
+
+    IndexType num_posts() const;
+
+    // rank and vertex of post p for applicant a, the rank of the last resort
+    // post is the size of the preference list plus one
+    RankType get_rank(IndexType a, IndexType p) const;
+    VertexPtr get_post(IndexType p) const;
+
+    // switch the path or cycle starting at post p in mate
+    void switch_from(IndexType p, IndexListType& mate) const;
+
+    // the matching in the graph where every applicant is matched as in mate
+    MatchedPairListType get_matching(const IndexListType& mate) const;
+
+public:
+    /// the switching graph of M, throws if M is not popular
+    SwitchingGraph(const BipartiteGraph& G, const MatchedPairListType& M);
+    virtual ~SwitchingGraph();
+
+    /// are the preferences of A strict and is every quota one
+    static bool is_applicable(const BipartiteGraph& G);
+
+    /// number of components with a cycle and of trees with at least one
+    /// switching path
+    IndexType num_cycles() const;
+    IndexType num_paths() const;
+
+    /// visit all the popular matchings, with a polynomial delay of
+    /// O(n log n) between two of them to build each matching
+    void enumerate(const VisitorType& visit) const;
+
+    /// a popular matching with the minimum total cost, in linear time
+    MatchedPairListType min_cost(const CostFunction& cost) const;
+
+    /// a popular matching of maximum size, and one with the minimum sum of
+    /// the ranks of the applicants
+    MatchedPairListType max_cardinality() const;
+    MatchedPairListType min_rank_sum() const;
+};
+
+#endif
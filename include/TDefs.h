@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 
 // forward declaration
 class Vertex;
@@ -12,12 +13,18 @@ class Node;
 /// Id type for a vertex
 typedef std::string IdType;
 
+/// Index type for a vertex in the dense (array based) view of a graph
+typedef unsigned IndexType;
+
 /// Id type for a node in flow network
 typedef int NodeType;
 
 /// Flow type (Integer flow) in flow network
 typedef int FlowType;
 
+/// Cost type in flow network (sum of ranks along the flow)
+typedef long CostType;
+
 // Rank representation for a vertex in the preference/partner list
 // this must be unique for all the vertex in a list
 typedef int RankType;
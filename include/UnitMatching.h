@@ -0,0 +1,83 @@
+#ifndef UNIT_MATCHING_H
+#define UNIT_MATCHING_H
+
+#include <vector>
+#include "GraphIndex.h"
+
+/// maximum matchings and Gallai-Edmonds decompositions of subgraphs of an
+/// instance where every applicant and every post has an upper quota of one,
+/// shared by UnitPopular and UnitRankMaximal
+/// a subgraph is given by the arcs of the applicants, and the matching is
+/// kept between calls, so that the matching of a subgraph is augmented to
+/// a maximum matching of the next one, every call is Hopcroft-Karp on
+/// arrays in O(sqrt(n) m) time
+class UnitMatching {
+public:
+    typedef GraphIndex::IndexListType IndexListType;
+
+    /// Gallai-Edmonds label of a vertex with respect to a maximum matching
+    enum Label : char { EVEN, ODD, UNREACHABLE };
+
+    /// no vertex or no edge
+    static const IndexType NONE;
+
+    /// arcs of the applicants of a subgraph, in the format of GraphIndex,
+    /// every arc remembers the edge of the instance it comes from (NONE for
+    /// posts which are not in the instance, like the last resort posts)
+    struct Adjacency {
+        IndexListType offsets;  // arcs of a are [offsets[a], offsets[a+1])
+        IndexListType heads;    // post of every arc
+        IndexListType edges;    // edge of every arc
+
+        Adjacency() : offsets(1, 0) {}
+
+        void clear() { offsets.assign(1, 0); heads.clear(); edges.clear(); }
+        void add_arc(IndexType b, IndexType e) { heads.emplace_back(b); edges.emplace_back(e); }
+        // closes the arcs of the next applicant
+        void end_applicant() { offsets.emplace_back(heads.size()); }
+    };
+
+private:
+    IndexListType A_mate_;          // post matched to an applicant
+    IndexListType A_edge_;          // edge through which it is matched
+    IndexListType B_mate_;          // applicant matched to a post
+    std::vector<Label> A_labels_;   // labels of the last decomposition
+    std::vector<Label> B_labels_;
+    bool decomposed_;               // has decompose been called
+    IndexListType dist_;            // layer of an applicant in the current phase
+    IndexListType arc_;             // current arc of an applicant in the current phase
+    IndexListType queue_, stack_;
+    IndexListType B_offsets_;       // arcs of the posts in the last decomposition
+    IndexListType B_heads_;
+
+    // layers of the applicants from the free applicants up to the first
+    // layer with an arc to a free post, returns that layer (NONE if there
+    // is no augmenting path)
+    IndexType build_layers(const Adjacency& G);
+
+    // looks for a shortest augmenting path from root along the layers, and
+    // flips it
+    bool augment(const Adjacency& G, IndexType root, IndexType last_layer);
+
+public:
+    UnitMatching(IndexType num_applicants, IndexType num_posts);
+    virtual ~UnitMatching();
+
+    /// augments the current matching to a maximum matching of G, whose
+    /// posts are [0, num_posts) (at least as many as before)
+    void maximum_matching(const Adjacency& G, IndexType num_posts);
+
+    /// labels of the vertices of G with respect to the current matching,
+    /// which must be a maximum matching of G
+    void decompose(const Adjacency& G);
+
+    IndexType get_A_mate(IndexType a) const { return A_mate_[a]; }
+    IndexType get_A_edge(IndexType a) const { return A_edge_[a]; }
+    IndexType get_B_mate(IndexType b) const { return B_mate_[b]; }
+
+    bool is_decomposed() const { return decomposed_; }
+    Label get_A_label(IndexType a) const { return A_labels_[a]; }
+    Label get_B_label(IndexType b) const { return B_labels_[b]; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef UNIT_POPULAR_H
+#define UNIT_POPULAR_H
+
+#include "MatchingAlgorithm.h"
+#include "GraphIndex.h"
+#include "UnitMatching.h"
+
+/// popular matching in a house allocation instance where every applicant
+/// and every post has an upper quota of one, only the preferences of the
+/// applicants (partition A) are used and they may contain ties
+/// this is the algorithm of Abraham, Irving, Kavitha and Mehlhorn, the
+/// f-posts and s-posts are found from a Gallai-Edmonds decomposition of the
+/// rank-1 graph, and both maximum matchings are computed by UnitMatching,
+/// in O(sqrt(n) m) time in total
+class UnitPopular : public MatchingAlgorithm {
+private:
+    GraphIndex index_;
+    UnitMatching matching_;     // last resort posts follow B, labelled in the rank-1 graph
+
+public:
+    UnitPopular(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
+    virtual ~UnitPopular();
+
+    /// does every vertex of G have an upper quota of one
+    static bool is_applicable(const BipartiteGraph& G);
+
+    /// Returns true if a popular matching exists, which is stored in M_
+    bool compute_matching();
+
+    /// the witness of ClassifiedPopular: every post which is odd or
+    /// unreachable in the rank-1 graph has alpha +1, and the applicants
+    /// matched to these posts through rank 1 edges have alpha -1, only the
+    /// applicants vote (check it with -c -t)
+    bool get_witness(PopularityWitness& witness);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef UNIT_RANK_MAXIMAL_H
+#define UNIT_RANK_MAXIMAL_H
+
+#include <vector>
+#include "MatchingAlgorithm.h"
+#include "GraphIndex.h"
+#include "UnitMatching.h"
+
+/// rank-maximal matching in an instance where every applicant and every
+/// post has an upper quota of one, ranked by the preferences of the
+/// applicants (partition A) which may contain ties
+/// this is the phase algorithm of Irving, Kavitha, Mehlhorn, Michail and
+/// Paluch: phase i augments the matching of phase i-1 to a maximum matching
+/// of the graph with the edges of rank at most i that are left, then the
+/// Gallai-Edmonds decomposition of that graph tells which edges cannot be
+/// in a rank-maximal matching and are deleted, every phase is Hopcroft-Karp
+/// on arrays (UnitMatching), in O(min(n + r, r sqrt(n)) m) time in total
+/// for r ranks
+class UnitRankMaximal : public MatchingAlgorithm {
+private:
+    GraphIndex index_;
+    UnitMatching matching_;         // labelled in the graph of the last phase
+    std::vector<char> deleted_;     // has an edge been deleted by a phase
+
+    // deletes the edges which are in no rank-maximal matching once the
+    // edges of rank at most rank are matched as well as possible
+    void delete_edges(RankType rank);
+
+public:
+    UnitRankMaximal(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
+    virtual ~UnitRankMaximal();
+
+    /// does every vertex of G have an upper quota of one
+    static bool is_applicable(const BipartiteGraph& G);
+
+    /// computes a rank-maximal matching and stores it in M_, returns true
+    bool compute_matching();
+};
+
+#endif
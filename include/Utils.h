@@ -19,6 +19,11 @@ int get_dummy_level(const IdType& id);
 // print matching in a compatible format with other code as described here
 // a,b,index(pref_list^a(b))
 void print_matching(const std::unique_ptr<BipartiteGraph>& G,
-                    MatchedPairListType& M, std::ostream& out);
+                    const MatchedPairListType& M, std::ostream& out);
+
+// read a matching in the format written by print_matching, the vertices are
+// looked up in G and partners in B are ranked by their preference lists
+MatchedPairListType read_matching(const std::unique_ptr<BipartiteGraph>& G,
+                                  std::istream& in);
 
 #endif
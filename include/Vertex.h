@@ -8,15 +8,26 @@
 #include "PreferenceList.h"
 #include "TDefs.h"
 
+class BipartiteGraph;
+
 class Vertex {
 private:
     IdType id_;                 // id of this vertex
     IdType cloned_for_id_;      // id of the vertex this was cloned for
+    IndexType index_;           // index of this vertex in its partition
+    const BipartiteGraph* graph_;   // graph which numbered this vertex, if any
     unsigned lower_quota_;           // least number of partners to this vertex
     unsigned upper_quota_;           // maximum number of partners to this vertex
     bool dummy_;                // is this a dummy vertex
     PreferenceList pref_list_;  // preference list according to priority
 
+    // a vertex in a reduced graph remembers the vertex of the original graph
+    // it was cloned for, its level, and for every position on its preference
+    // list the rank of the corresponding vertex on the list of the origin
+    VertexPtr origin_;                  // vertex this was cloned for, if recorded
+    int level_;                         // level of this copy in the reduced graph
+    std::vector<RankType> origin_ranks_; // ranks on the list of origin_, 0 for dummies
+
 public:
     Vertex(const IdType& id);
     Vertex(const IdType& id, unsigned upper_quota);
@@ -32,6 +43,30 @@ public:
     unsigned get_upper_quota() const;
     bool is_dummy() const;
 
+    /// index of this vertex in its partition, assigned by the BipartiteGraph
+    /// which owns it, vertices which are not in any graph have an invalid index
+    /// and no graph, a vertex belongs to at most one graph at a time
+    IndexType get_index() const;
+    const BipartiteGraph* get_graph() const;
+    void set_index(const BipartiteGraph* graph, IndexType index);
+
+    /// the vertex of the original graph this vertex was cloned for in a
+    /// reduced graph and the level of this copy, the origin is a null
+    /// pointer if the reduction did not record it
+    void set_origin(const VertexPtr& origin, int level);
+    const VertexPtr& get_origin() const;
+    int get_level() const;
+
+    /// append v to the preference list (with a strictly larger rank), where
+    /// origin_rank is the rank of the vertex v was cloned for on the list of
+    /// the origin of this vertex, and 0 if v is a dummy, a reduction has to
+    /// add every entry of the list through this for the ranks to line up
+    void emplace_back_with_origin(VertexPtr v, RankType origin_rank);
+
+    /// rank on the list of the origin of the vertex at the given rank on
+    /// this list, 0 if it is not known, O(1)
+    RankType get_origin_rank(RankType rank) const;
+
     PreferenceList& get_preference_list();
     const PreferenceList& get_preference_list() const;
 };
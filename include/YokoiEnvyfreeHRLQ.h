@@ -4,10 +4,6 @@
 #include "MatchingAlgorithm.h"
 
 class YokoiEnvyfreeHRLQ : public MatchingAlgorithm {
-private:
-    // augment graph to compute matching
-    std::unique_ptr<BipartiteGraph> augment_graph();
-
 public:
     YokoiEnvyfreeHRLQ(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing=true);
     virtual ~YokoiEnvyfreeHRLQ();
@@ -0,0 +1,57 @@
+#include "AssignmentNetwork.h"
+#include "BipartiteGraph.h"
+#include "PartnerList.h"
+#include "Vertex.h"
+
+AssignmentNetwork::AssignmentNetwork(const GraphIndex& index)
+    : index_(index),
+      H_(2 + index.num_A_vertices() + index.num_B_vertices()),
+      source_(new Node("source", 0, Node::ROLE_SOURCE)),
+      sink_(new Node("sink", 1, Node::ROLE_SINK)),
+      arcs_(index.num_edges())
+{
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        H_.add_edge(0, A_node(a), index_.get_A_quota(a), 0);
+    }
+
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        arcs_[e] = H_.add_edge(A_node(index_.get_tail(e)), B_node(index_.get_head(e)),
+                               1, index_.get_A_rank(e));
+    }
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        H_.add_edge(B_node(b), 1, index_.get_B_quota(b), 0);
+    }
+}
+
+AssignmentNetwork::~AssignmentNetwork()
+{}
+
+FlowType AssignmentNetwork::compute_max_flow() {
+    return H_.compute_max_flow(source_, sink_);
+}
+
+FlowType AssignmentNetwork::compute_min_cost_flow(CostType& cost) {
+    return H_.compute_min_cost_flow(source_, sink_, cost);
+}
+
+bool AssignmentNetwork::is_matched(IndexType e) const {
+    return H_.get_flow(arcs_[e]) > 0;
+}
+
+void AssignmentNetwork::get_matched_pairs(MatchedPairListType& M) const {
+    const auto& A = index_.get_graph().get_A_vertices();
+    const auto& B = index_.get_graph().get_B_vertices();
+
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        if (is_matched(e)) {
+            const auto& a = A[index_.get_tail(e)];
+            const auto& b = B[index_.get_head(e)];
+            auto b_rank = index_.get_B_rank(e);
+
+            M[a].add_partner(std::make_pair(index_.get_A_rank(e), b));
+            M[b].add_partner(std::make_pair(
+                b_rank == GraphIndex::UNRANKED ? 1 : b_rank, a));
+        }
+    }
+}
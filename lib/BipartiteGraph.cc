@@ -1,16 +1,47 @@
 #include "BipartiteGraph.h"
 #include "Vertex.h"
 #include "PartnerList.h"
-#include <set>
-#include <queue>
+#include "HopcroftKarp.h"
+#include "ReducedGraphCache.h"
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 
 BipartiteGraph::BipartiteGraph(const ContainerType& A, const ContainerType& B)
-    : A_(A), B_(B)
-{}
+    : A_(A), B_(B), reduced_graphs_(new ReducedGraphCache())
+{
+    // number the vertices of each partition in the order of their ids, a
+    // vertex numbered by another graph would lose its index in that graph
+    auto index_vertices = [this] (const ContainerType& vertices,
+                                  IndexedContainerType& indexed)
+    {
+        indexed.reserve(vertices.size());
+
+        for (const auto& it : vertices) {
+            if (it.second->get_graph() != nullptr) {
+                throw std::logic_error("vertex " + it.second->get_id()
+                                       + " already belongs to a graph");
+            }
+
+            it.second->set_index(this, indexed.size());
+            indexed.emplace_back(it.second);
+        }
+    };
 
-BipartiteGraph::~BipartiteGraph()
-{}
+    index_vertices(A_, A_vertices_);
+    index_vertices(B_, B_vertices_);
+}
+
+BipartiteGraph::~BipartiteGraph() {
+    // the vertices may outlive the graph and join another one
+    for (const auto& v : A_vertices_) {
+        v->set_index(nullptr, std::numeric_limits<IndexType>::max());
+    }
+
+    for (const auto& v : B_vertices_) {
+        v->set_index(nullptr, std::numeric_limits<IndexType>::max());
+    }
+}
 
 const BipartiteGraph::ContainerType& BipartiteGraph::get_A_partition() const {
     return A_;
@@ -20,83 +51,21 @@ const BipartiteGraph::ContainerType& BipartiteGraph::get_B_partition() const {
     return B_;
 }
 
-bool BipartiteGraph::has_augmenting_path(const MatchedPairListType& M) const {
-    // the second entry of the pair is true if
-    // the vertex belongs to partition A, otherwise false
-    std::queue<std::pair<VertexPtr, bool>> Q;
-    std::set<VertexPtr> visited;
-
-    // populate the queue with vertices from A
-    // which can participate in an augmenting path
-    // these are precisely the vertices that are unmatched
-    for (auto it : get_A_partition()) {
-        auto u = it.second;
-        auto uit = M.find(u);
-
-        if (uit == M.cend() or uit->second.size() == 0) {
-            // u is a vertex from partition A
-            Q.emplace(std::make_pair(u, true));
-
-            // mark u as visited
-            visited.emplace(u);
-        }
-    }
+const BipartiteGraph::IndexedContainerType& BipartiteGraph::get_A_vertices() const {
+    return A_vertices_;
+}
 
-    while (not Q.empty()) {
-        // remove a vertex from the queue
-        auto it = Q.front();
-        Q.pop();
-
-        // get the preference list and the matched partners
-        auto u = it.first;
-        auto uit = M.find(u);
-        auto& pl = u->get_preference_list();
-        auto& partners = uit == M.end() ? PartnerList() : uit->second;
-
-        if (it.second) {
-            // u is a vertex belonging to partition A
-            // go through the neigbours of this vertex
-            for (auto i = pl.all_begin(), e = pl.all_end(); i != e; ++i) {
-                auto v = pl.get_vertex(*i);
-
-                // only add if this vertex has not been visited
-                // and is not matched to u
-                if (visited.find(v) == visited.end() and
-                    partners.find(v) == partners.cend())
-                {
-                    // v is a vertex from partition B
-                    Q.emplace(std::make_pair(v, false));
-
-                    // we have seen this vertex
-                    visited.emplace(v);
-                }
-            }
-        } else {
-            // u is a vertex from partition B
-            // if u is matched to less than upper quota vertices
-            // or u is unmatched |M(u)| = 0
-            // this is an augmenting path
-            if (partners.size() < u->get_upper_quota()) {
-                return true;
-            } else {
-                // add all the matched neighbours
-                for (auto i = partners.cbegin(), e = partners.cend(); i != e; ++i) {
-                    auto v = partners.get_vertex(i);
-
-                    // only add if this vertex has not been visited
-                    if (visited.find(v) == visited.end()) {
-                        // v is a vertex from partition A
-                        Q.emplace(std::make_pair(v, true));
-
-                        // we have seen this vertex
-                        visited.emplace(v);
-                    }
-                }
-            }
-        }
-    }
+const BipartiteGraph::IndexedContainerType& BipartiteGraph::get_B_vertices() const {
+    return B_vertices_;
+}
+
+bool BipartiteGraph::has_augmenting_path(const MatchedPairListType& M) const {
+    HopcroftKarp hk(*this);
+    return hk.has_augmenting_path(M);
+}
 
-    return false;
+ReducedGraphCache& BipartiteGraph::get_reduced_graphs() const {
+    return *reduced_graphs_;
 }
 
 std::ostream& operator<<(std::ostream& out, const std::unique_ptr<BipartiteGraph>& G) {
@@ -0,0 +1,118 @@
+#include "ClassificationNetwork.h"
+
+ClassificationNetwork::ClassificationNetwork(const GraphIndex& index)
+    : index_(index),
+      H_(2 + index.num_A_vertices() + index.num_B_vertices()),
+      source_(new Node("source", 0, Node::ROLE_SOURCE)),
+      sink_(new Node("sink", 1, Node::ROLE_SINK)),
+      arcs_(index.num_edges(), -1),
+      last_resort_arcs_(index.num_A_vertices(), -1),
+      kept_(index.num_edges(), false),
+      last_resort_kept_(index.num_A_vertices(), false)
+{
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+    IndexType m = index_.num_edges();
+
+    for (IndexType a = 0; a < nA; ++a) {
+        H_.add_edge(0, A_root(a), index_.get_A_quota(a), 0);
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        H_.add_edge(B_root(b), 1, index_.get_B_quota(b), 0);
+    }
+
+    // the full network has two leaves per edge and four nodes per
+    // applicant for its last resort post, with an edge into every leaf and
+    // the last resort root, and out of the last resort root
+    stats_.nodes = 2 + nA + nB;
+    stats_.edges = nA + nB;
+    stats_.nodes_saved = 2 * m + 3 * nA;
+    stats_.edges_saved = 2 * m + 3 * nA;
+}
+
+ClassificationNetwork::~ClassificationNetwork()
+{}
+
+void ClassificationNetwork::add_edge(IndexType e, RankType rank) {
+    // a second edge between the same leaves adds no capacity to the path
+    if (arcs_[e] == -1) {
+        arcs_[e] = H_.add_edge(A_root(index_.get_tail(e)), B_root(index_.get_head(e)), 1, rank);
+        new_edges_.push_back(e);
+        ++stats_.edges;
+    }
+}
+
+void ClassificationNetwork::add_last_resort_edge(IndexType a, RankType rank) {
+    if (last_resort_arcs_[a] == -1) {
+        last_resort_arcs_[a] = H_.add_edge(A_root(a), 1, 1, rank);
+        ++stats_.edges;
+    }
+}
+
+FlowType ClassificationNetwork::compute_max_flow() {
+    return H_.compute_max_flow(source_, sink_);
+}
+
+void ClassificationNetwork::decompose_nodes_STU() {
+    H_.decompose_nodes_STU(source_, sink_);
+}
+
+void ClassificationNetwork::delete_edges_into_S() {
+    // the edges carrying flow which are deleted are those between an S node
+    // and another node, only the new edges and those of the relabelled
+    // roots can be such edges for the first time
+    auto crosses_S = [this] (NodeType arc) {
+        return arc != -1 && H_.get_flow(arc) > 0 &&
+               (H_.get_label(H_.get_tail(arc)) == Node::LABEL_S) !=
+               (H_.get_label(H_.get_head(arc)) == Node::LABEL_S);
+    };
+
+    auto keep_edge = [&] (IndexType e) {
+        if (crosses_S(arcs_[e])) {
+            kept_[e] = true;
+        }
+    };
+
+    for (IndexType e : new_edges_) {
+        keep_edge(e);
+    }
+    for_each_relabelled_edge(keep_edge);
+    new_edges_.clear();
+
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        if (crosses_S(last_resort_arcs_[a])) {
+            last_resort_kept_[a] = true;
+        }
+    }
+
+    H_.delete_edges_into_S();
+}
+
+Node::DecompositionLabel ClassificationNetwork::get_A_label(IndexType a) const {
+    return H_.get_label(A_root(a));
+}
+
+Node::DecompositionLabel ClassificationNetwork::get_B_label(IndexType b) const {
+    return H_.get_label(B_root(b));
+}
+
+bool ClassificationNetwork::is_matched(IndexType e) const {
+    return kept_[e] || (arcs_[e] != -1 && H_.get_flow(arcs_[e]) > 0);
+}
+
+bool ClassificationNetwork::is_last_resort_matched(IndexType a) const {
+    return last_resort_kept_[a] ||
+           (last_resort_arcs_[a] != -1 && H_.get_flow(last_resort_arcs_[a]) > 0);
+}
+
+const ClassificationNetwork::Statistics& ClassificationNetwork::get_statistics() const {
+    return stats_;
+}
+
+std::ostream& operator<<(std::ostream& out, const ClassificationNetwork::Statistics& stats) {
+    return out << "classification_network_nodes," << stats.nodes << '\n'
+               << "classification_network_edges," << stats.edges << '\n'
+               << "classification_network_nodes_saved," << stats.nodes_saved << '\n'
+               << "classification_network_edges_saved," << stats.edges_saved << '\n';
+}
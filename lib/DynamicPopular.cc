@@ -0,0 +1,363 @@
+#include "DynamicPopular.h"
+#include "SwitchingGraph.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const IndexType NONE = std::numeric_limits<IndexType>::max();
+const IndexType LAST_RESORT = NONE - 1;
+
+}
+
+DynamicPopular::DynamicPopular(const BipartiteGraph& G)
+    : B_(G.get_B_vertices()), nsearches_(0), stats_{0, 0, 0, 0}
+{
+    if (not is_applicable(G)) {
+        throw std::runtime_error("dynamic popular matchings need strict preferences and quotas of one");
+    }
+
+    for (IndexType p = 0; p < B_.size(); ++p) {
+        B_indices_.emplace(B_[p]->get_id(), p);
+    }
+
+    f_applicants_.resize(B_.size());
+    listed_by_.resize(B_.size());
+    B_mate_.assign(B_.size(), NONE);
+
+    for (const auto& u : G.get_A_vertices()) {
+        IndexType a = A_.size();
+        A_.emplace_back(u);
+        A_indices_.emplace(u->get_id(), a);
+
+        IndexListType pref_list;
+        auto& u_pref_list = u->get_preference_list();
+        for (auto i = u_pref_list.all_begin(), e = u_pref_list.all_end(); i != e; ++i) {
+            pref_list.emplace_back(u_pref_list.get_vertex(*i)->get_index());
+        }
+
+        pref_lists_.emplace_back();
+        s_.emplace_back(NONE);
+        A_mate_.emplace_back(NONE);
+        seen_.emplace_back(0);
+        parent_.emplace_back(NONE);
+        attach(a, pref_list);
+    }
+
+    repair();
+}
+
+DynamicPopular::~DynamicPopular()
+{}
+
+bool DynamicPopular::is_applicable(const BipartiteGraph& G) {
+    return SwitchingGraph::is_applicable(G);
+}
+
+bool DynamicPopular::is_f_post(IndexType p) const {
+    return p < B_.size() and not f_applicants_[p].empty();
+}
+
+IndexType DynamicPopular::find_s_post(IndexType a) const {
+    for (auto p : pref_lists_[a]) {
+        if (not is_f_post(p)) {
+            return p;
+        }
+    }
+
+    return LAST_RESORT;
+}
+
+void DynamicPopular::unmatch(IndexType a) {
+    auto p = A_mate_[a];
+
+    if (p < B_.size()) {
+        B_mate_[p] = NONE;
+
+        if (is_f_post(p)) {
+            pending_.emplace(p);
+        }
+    }
+
+    A_mate_[a] = NONE;
+    free_.emplace(a);
+}
+
+void DynamicPopular::f_post_added(IndexType p) {
+    // p was s(b) for these applicants, and the post was matched, if at all,
+    // to one of them
+    for (auto b : listed_by_[p]) {
+        if (s_[b] == p) {
+            if (A_mate_[b] == p) {
+                unmatch(b);
+            }
+
+            s_[b] = find_s_post(b);
+        }
+    }
+
+    pending_.emplace(p);
+}
+
+void DynamicPopular::f_post_removed(IndexType p) {
+    // p may now be s(b) for the applicants listing it
+    for (auto b : listed_by_[p]) {
+        auto s = find_s_post(b);
+
+        if (s != s_[b]) {
+            if (A_mate_[b] == s_[b]) {
+                unmatch(b);
+            }
+
+            s_[b] = s;
+        }
+    }
+}
+
+void DynamicPopular::detach(IndexType a) {
+    if (A_mate_[a] != NONE and A_mate_[a] != LAST_RESORT) {
+        unmatch(a);
+    }
+
+    A_mate_[a] = NONE;
+    free_.erase(a);
+
+    auto& pref_list = pref_lists_[a];
+    for (auto p : pref_list) {
+        listed_by_[p].erase(a);
+    }
+
+    if (not pref_list.empty()) {
+        auto f = pref_list.front();
+        f_applicants_[f].erase(a);
+
+        if (f_applicants_[f].empty()) {
+            f_post_removed(f);
+        }
+    }
+
+    pref_list.clear();
+    s_[a] = NONE;
+}
+
+void DynamicPopular::attach(IndexType a, const IndexListType& pref_list) {
+    pref_lists_[a] = pref_list;
+    for (auto p : pref_list) {
+        listed_by_[p].emplace(a);
+    }
+
+    // a is matched to its last resort post in every popular matching
+    if (pref_list.empty()) {
+        s_[a] = LAST_RESORT;
+        A_mate_[a] = LAST_RESORT;
+        return;
+    }
+
+    auto f = pref_list.front();
+    bool added = f_applicants_[f].empty();
+    f_applicants_[f].emplace(a);
+
+    if (added) {
+        f_post_added(f);
+    }
+
+    s_[a] = find_s_post(a);
+    A_mate_[a] = NONE;
+    free_.emplace(a);
+}
+
+bool DynamicPopular::augment(IndexType a) {
+    IndexListType queue(1, a);
+    seen_[a] = ++nsearches_;
+
+    // every applicant has the edges to f(u) and s(u), the last resort post
+    // of u is never matched to anyone else
+    for (IndexType i = 0; i < queue.size(); ++i) {
+        auto u = queue[i];
+        IndexType posts[] = { pref_lists_[u].front(), s_[u] };
+        ++stats_.visited;
+
+        for (auto q : posts) {
+            if (q == A_mate_[u]) {
+                continue;
+            }
+
+            if (q == LAST_RESORT or B_mate_[q] == NONE) {
+                // every applicant on the path takes the post it points to
+                while (true) {
+                    auto prev = A_mate_[u];
+                    A_mate_[u] = q;
+
+                    if (q != LAST_RESORT) {
+                        B_mate_[q] = u;
+                    }
+
+                    if (u == a) {
+                        return true;
+                    }
+
+                    q = prev;
+                    u = parent_[u];
+                }
+            }
+
+            auto v = B_mate_[q];
+            if (seen_[v] != nsearches_) {
+                seen_[v] = nsearches_;
+                parent_[v] = u;
+                queue.emplace_back(v);
+            }
+        }
+    }
+
+    return false;
+}
+
+void DynamicPopular::repair() {
+    // the matching stays maximum in the reduced graph, an applicant without
+    // an augmenting path now has none after the other augmentations either
+    std::vector<IndexType> applicants(free_.begin(), free_.end());
+    for (auto a : applicants) {
+        if (augment(a)) {
+            free_.erase(a);
+            ++stats_.augmentations;
+        }
+    }
+
+    // an unmatched f-post p takes an applicant a with f(a) = p, which is
+    // matched to s(a) as p is free
+    std::vector<IndexType> posts(pending_.begin(), pending_.end());
+    for (auto p : posts) {
+        if (not is_f_post(p) or B_mate_[p] != NONE) {
+            pending_.erase(p);
+            continue;
+        }
+
+        for (auto a : f_applicants_[p]) {
+            auto s = A_mate_[a];
+
+            if (s != NONE) {
+                if (s != LAST_RESORT) {
+                    B_mate_[s] = NONE;
+                }
+
+                A_mate_[a] = p;
+                B_mate_[p] = a;
+                pending_.erase(p);
+                ++stats_.promotions;
+                break;
+            }
+        }
+    }
+}
+
+bool DynamicPopular::set_preferences(const IdType& id, const std::vector<IdType>& pref_list) {
+    IndexListType posts;
+    std::set<IndexType> listed;
+
+    for (const auto& b : pref_list) {
+        auto it = B_indices_.find(b);
+
+        if (it == B_indices_.end()) {
+            throw std::runtime_error("unknown post " + b + " on the list of " + id);
+        } else if (not listed.emplace(it->second).second) {
+            throw std::runtime_error("post " + b + " is listed twice by " + id);
+        }
+
+        posts.emplace_back(it->second);
+    }
+
+    auto it = A_indices_.find(id);
+    IndexType a = 0;
+
+    if (it == A_indices_.end()) {
+        a = A_.size();
+        A_.emplace_back(std::make_shared<Vertex>(id));
+        A_indices_.emplace(id, a);
+        pref_lists_.emplace_back();
+        s_.emplace_back(NONE);
+        A_mate_.emplace_back(NONE);
+        seen_.emplace_back(0);
+        parent_.emplace_back(NONE);
+    } else {
+        a = it->second;
+        detach(a);
+    }
+
+    attach(a, posts);
+    repair();
+    ++stats_.edits;
+
+    return has_popular_matching();
+}
+
+bool DynamicPopular::remove_applicant(const IdType& id) {
+    auto it = A_indices_.find(id);
+
+    if (it == A_indices_.end()) {
+        throw std::runtime_error("unknown applicant " + id);
+    }
+
+    detach(it->second);
+    A_indices_.erase(it);
+    repair();
+    ++stats_.edits;
+
+    return has_popular_matching();
+}
+
+bool DynamicPopular::has_popular_matching() const {
+    return free_.empty();
+}
+
+MatchedPairListType DynamicPopular::get_matched_pairs() const {
+    MatchedPairListType M;
+
+    for (const auto& it : A_indices_) {
+        auto a = it.second;
+        auto p = A_mate_[a];
+
+        // applicants matched to their last resort posts are left unmatched
+        if (p < B_.size()) {
+            RankType rank = 1;
+            while (pref_lists_[a][rank - 1] != p) {
+                ++rank;
+            }
+
+            M[A_[a]].add_partner(std::make_pair(rank, B_[p]));
+            M[B_[p]].add_partner(std::make_pair(1, A_[a]));
+        }
+    }
+
+    return M;
+}
+
+void DynamicPopular::write_matching(std::ostream& out) const {
+    auto M = get_matched_pairs();
+
+    for (const auto& it : A_indices_) {
+        auto M_a = M.find(A_[it.second]);
+
+        if (M_a != M.end()) {
+            auto& partners = M_a->second;
+            auto pit = partners.cbegin();
+
+            out << it.first << ','
+                << partners.get_vertex(pit)->get_id() << ','
+                << partners.get_rank(pit) << '\n';
+        }
+    }
+}
+
+const DynamicPopular::Statistics& DynamicPopular::get_statistics() const {
+    return stats_;
+}
+
+std::ostream& operator<<(std::ostream& out, const DynamicPopular::Statistics& stats) {
+    return out << "dynamic_popular_edits," << stats.edits << '\n'
+               << "dynamic_popular_augmentations," << stats.augmentations << '\n'
+               << "dynamic_popular_promotions," << stats.promotions << '\n'
+               << "dynamic_popular_visited," << stats.visited << '\n';
+}
@@ -1,13 +1,42 @@
 #include "FlowNetwork.h"
+#include "Parallel.h"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <queue>
+#include <stdexcept>
+
+namespace {
+
+// parent edge of a node which is not in a search tree, and of the root
+const NodeType NO_EDGE = -1;
+const NodeType ROOT_EDGE = -2;
+
+// level_bfs goes bottom up once the edges of a level are more than
+// 1 / BOTTOM_UP_ALPHA of the edges of the nodes not reached yet, and top
+// down again when a level has less than 1 / BOTTOM_UP_BETA of the nodes
+// (Beamer, Asanovic and Patterson, Direction-optimizing breadth-first search)
+const long BOTTOM_UP_ALPHA = 14;
+const NodeType BOTTOM_UP_BETA = 24;
+
+}
+
+const NodeType FlowNetwork::AUTO_DEPTH;
+FlowNetwork::MaxFlowAlgorithm FlowNetwork::default_algorithm_ = FlowNetwork::AUTO;
+FlowNetwork::DecompositionMode FlowNetwork::decomposition_mode_ = FlowNetwork::INCREMENTAL;
 
 FlowNetwork::FlowNetwork()
+	: num_nodes_(0), adj_offsets_(1, 0), adj_valid_(true), checked_edges_(0),
+	  decomposed_source_(NO_EDGE), decomposed_sink_(NO_EDGE)
 {}
 
 FlowNetwork::FlowNetwork(NodeType num_nodes)
-	: num_nodes_(num_nodes), edges_(0), adj_list_(num_nodes),
-	  dist_(num_nodes), path_to_traverse_(num_nodes)
+	: num_nodes_(num_nodes), nodes_(num_nodes), adj_offsets_(num_nodes + 1, 0),
+	  adj_valid_(true), dist_(num_nodes), path_to_traverse_(num_nodes),
+	  labels_(num_nodes, Node::LABEL_U), checked_edges_(0),
+	  decomposed_source_(NO_EDGE), decomposed_sink_(NO_EDGE)
 {}
 
 FlowNetwork::~FlowNetwork()
@@ -21,246 +50,908 @@ void FlowNetwork::add_edges(const EdgeList& edges) {
 
 void FlowNetwork::add_edge(NodePtr U, NodePtr V, FlowType capacity, RankType rank) {
 	if (U->get_id() != V->get_id()) {
-		// Both (u,v) and (v,u) edges are added, with 0 capacity for reverse edge
-		// This is done for ease of pushing flow across paths
-		// edges_[index] and Edges[index ^ 1] are edges in opposite directions
+		nodes_[U->get_id()] = U;
+		nodes_[V->get_id()] = V;
+		add_edge(U->get_id(), V->get_id(), capacity, rank);
+	}
+}
 
-		// Add (u,v) edge with given capacity and rank
-		edges_.push_back(Edge(U, V, capacity, rank));
-		adj_list_[U->get_id()].push_back(edges_.size() - 1);
+NodeType FlowNetwork::add_edge(NodeType u, NodeType v, FlowType capacity, RankType rank) {
+	if (u == v) {
+		return -1;
+	}
+
+	// Both (u,v) and (v,u) edges are added, with 0 capacity for reverse edge
+	// This is done for ease of pushing flow across paths
+	// edges_[index] and Edges[index ^ 1] are edges in opposite directions
+
+	// Add (u,v) edge with given capacity and rank
+	heads_.push_back(v);
+	capacities_.push_back(capacity);
+	flows_.push_back(0);
+	ranks_.push_back(rank);
+
+	// Add (v,u) edge with 0 capacity and rank
+	heads_.push_back(u);
+	capacities_.push_back(0);
+	flows_.push_back(0);
+	ranks_.push_back(0);
+
+	touched_.push_back(false);
+	touch_edge(heads_.size() - 1);
+	adj_valid_ = false;
+
+	return heads_.size() - 2;
+}
+
+void FlowNetwork::add_edge(NodePtr U, NodePtr V, FlowType lower, FlowType capacity, RankType rank) {
+	if (U->get_id() != V->get_id()) {
+		lower_inflows_.resize(num_nodes_, 0);
+		lower_inflows_[V->get_id()] += lower;
+		lower_inflows_[U->get_id()] -= lower;
+	}
+
+	add_edge(U, V, capacity - lower, rank);
+}
+
+void FlowNetwork::touch_edge(NodeType edge_id) {
+	if (!touched_[edge_id >> 1]) {
+		touched_[edge_id >> 1] = true;
+		touched_edges_.push_back(edge_id >> 1);
+	}
+}
+
+void FlowNetwork::build_adjacency() {
+	if (adj_valid_) {
+		return;
+	}
+
+	// Count the edges leaving every node, and place the edge ids in the
+	// order they were added
+	fill(adj_offsets_.begin(), adj_offsets_.end(), 0);
+	for (NodeType edge_id = 0; edge_id < (int)heads_.size(); ++edge_id) {
+		++adj_offsets_[get_tail(edge_id) + 1];
+	}
+
+	for (NodeType node = 0; node < num_nodes_; ++node) {
+		adj_offsets_[node + 1] += adj_offsets_[node];
+	}
 
-		// Add (v,u) edge with 0 capacity and rank
-		edges_.push_back(Edge(V, U, 0, 0));
-		adj_list_[V->get_id()].push_back(edges_.size() - 1);
+	std::vector<NodeType> next(adj_offsets_.begin(), adj_offsets_.end() - 1);
+	adj_edges_.resize(heads_.size());
+	for (NodeType edge_id = 0; edge_id < (int)heads_.size(); ++edge_id) {
+		adj_edges_[next[get_tail(edge_id)]++] = edge_id;
 	}
+
+	adj_valid_ = true;
 }
 
-void FlowNetwork::delete_edges(IdType decomposition_label_u,
-							   IdType decomposition_label_v) {
-	for (NodeType edge_id = 0; edge_id < (int)edges_.size(); ++edge_id) {
-		Edge& edge = edges_[edge_id];
-
-		// Check if edge is between nodes of corresponding decomposition labels
-		if (is_edge_label(edge, decomposition_label_u, decomposition_label_v)) { 
-			// Delete edge by setting capacity and flow to 0
-			edge.set_capacity(0);
-			edge.set_flow(0);
-
-			// Set the capacity and flow of reverse edge to 0
-			Edge& reverse_edge = edges_[edge_id ^ 1];
-			reverse_edge.set_capacity(0);
-			reverse_edge.set_flow(0);
+void FlowNetwork::delete_edges_into_S() {
+	build_adjacency();
+
+	// An edge between nodes whose labels did not change was deleted by the
+	// last call if needed, so look at the edges of the changed nodes (in
+	// both directions) and at the new edges
+	for (NodeType node : changed_nodes_) {
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			delete_if_into_S(edge_id);
+			delete_if_into_S(edge_id ^ 1);
 		}
 	}
+
+	for (NodeType edge_id = checked_edges_; edge_id < (int)heads_.size(); ++edge_id) {
+		delete_if_into_S(edge_id);
+	}
+
+	changed_nodes_.clear();
+	checked_edges_ = heads_.size();
+}
+
+void FlowNetwork::delete_if_into_S(NodeType edge_id) {
+	// Check if edge is from a T or U node to an S node
+	if (labels_[heads_[edge_id]] == Node::LABEL_S &&
+		labels_[get_tail(edge_id)] != Node::LABEL_S) {
+		// Delete edge by setting capacity and flow to 0
+		touch_edge(edge_id);
+		capacities_[edge_id] = 0;
+		flows_[edge_id] = 0;
+
+		// Set the capacity and flow of reverse edge to 0
+		capacities_[edge_id ^ 1] = 0;
+		flows_[edge_id ^ 1] = 0;
+	}
 }
 
 FlowType FlowNetwork::compute_max_flow(NodePtr source, NodePtr sink) {
-	FlowType total_flow = 0;
+	return compute_max_flow(source, sink, default_algorithm_);
+}
+
+FlowType FlowNetwork::compute_max_flow(NodePtr source, NodePtr sink,
+									   MaxFlowAlgorithm algorithm) {
+	build_adjacency();
 
 	// Check if path exists between source and sink
-	while (path_between(source->get_id(), sink->get_id())) {
+	if (!path_between(source->get_id(), sink->get_id())) {
+		return 0;
+	}
+
+	// Long augmenting paths mean many phases for Dinic's algorithm
+	if (algorithm == AUTO) {
+		algorithm = dist_[sink->get_id()] > AUTO_DEPTH ? PUSH_RELABEL : DINIC;
+	}
+
+	if (algorithm == PUSH_RELABEL) {
+		return push_relabel(source->get_id(), sink->get_id());
+	} else {
+		return dinic(source->get_id(), sink->get_id());
+	}
+}
+
+void FlowNetwork::set_default_algorithm(MaxFlowAlgorithm algorithm) {
+	default_algorithm_ = algorithm;
+}
+
+FlowNetwork::MaxFlowAlgorithm FlowNetwork::get_default_algorithm() {
+	return default_algorithm_;
+}
+
+void FlowNetwork::set_decomposition_mode(DecompositionMode mode) {
+	decomposition_mode_ = mode;
+}
+
+FlowNetwork::DecompositionMode FlowNetwork::get_decomposition_mode() {
+	return decomposition_mode_;
+}
+
+FlowType FlowNetwork::dinic(NodeType source, NodeType sink) {
+	FlowType total_flow = 0;
+
+	do {
 		fill(path_to_traverse_.begin(), path_to_traverse_.end(), 0);
 
-		// Keep sending flow through paths from source to sink 
-		while(FlowType flow = send_flow(source->get_id(), sink->get_id())) {
-			total_flow += flow;
+		// Send a blocking flow through the paths from source to sink
+		total_flow += send_flow(source, sink);
+	} while (path_between(source, sink));
+
+	return total_flow;
+}
+
+FlowType FlowNetwork::push_relabel(NodeType source, NodeType sink) {
+	// The current flow is a flow, so only the source gets an excess by
+	// saturating its edges
+	excess_.assign(num_nodes_, 0);
+	heights_.assign(num_nodes_, 0);
+	height_counts_.assign(num_nodes_ + 1, 0);
+
+	for (NodeType neigh_id = adj_offsets_[source]; neigh_id < adj_offsets_[source + 1]; neigh_id++) {
+		NodeType edge_id = adj_edges_[neigh_id];
+		FlowType residual = capacities_[edge_id] - flows_[edge_id];
+
+		if (residual > 0) {
+			touch_edge(edge_id);
+			flows_[edge_id] += residual;
+			flows_[edge_id ^ 1] -= residual;
+			excess_[heads_[edge_id]] += residual;
+		}
+	}
+
+	// Phase 1 finds a maximum preflow, whose excess is then sent back to
+	// the source in phase 2 as it cannot reach the sink anymore
+	discharge_all(sink, source, true);
+	discharge_all(source, sink, false);
+
+	return excess_[sink];
+}
+
+void FlowNetwork::global_relabel(NodeType target, NodeType other) {
+	// Perform a bfs from target on the reverse residual network
+	std::queue<NodeType> bfs_queue;
+	bfs_queue.push(target);
+
+	fill(heights_.begin(), heights_.end(), num_nodes_);
+	fill(height_counts_.begin(), height_counts_.end(), 0);
+	heights_[target] = 0;
+
+	while (!bfs_queue.empty()) {
+		NodeType node = bfs_queue.front();
+		bfs_queue.pop();
+		++height_counts_[heights_[node]];
+
+		// Edge (node, v) gives the residual edge (v, node) through its reverse
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			NodeType head = heads_[edge_id];
+
+			if (head != other && heights_[head] == num_nodes_ &&
+				flows_[edge_id ^ 1] < capacities_[edge_id ^ 1]) {
+				heights_[head] = heights_[node] + 1;
+				bfs_queue.push(head);
+			}
+		}
+	}
+
+	heights_[other] = num_nodes_;
+	fill(path_to_traverse_.begin(), path_to_traverse_.end(), 0);
+}
+
+void FlowNetwork::discharge_all(NodeType target, NodeType other, bool use_gap) {
+	// Labels at or above num_nodes_ cannot reach target while use_gap, in
+	// phase 2 every node with an excess can reach target
+	NodeType max_height = use_gap ? num_nodes_ : 2 * num_nodes_;
+	std::queue<NodeType> active;
+	long work = 0;
+
+	auto activate_all = [&] () {
+		for (NodeType node = 0; node < num_nodes_; ++node) {
+			if (node != target && node != other && excess_[node] > 0 &&
+				heights_[node] < max_height) {
+				active.push(node);
+			}
+		}
+	};
+
+	global_relabel(target, other);
+	activate_all();
+
+	while (!active.empty()) {
+		NodeType node = active.front();
+		active.pop();
+
+		// Global relabeling after about as much work as a bfs
+		if (work > 6 * num_nodes_ + (long)heads_.size()) {
+			work = 0;
+			std::queue<NodeType>().swap(active);
+			global_relabel(target, other);
+			activate_all();
+			continue;
+		}
+
+		NodeType begin = adj_offsets_[node];
+		NodeType degree = adj_offsets_[node + 1] - begin;
+		NodeType &path_id = path_to_traverse_[node];
+
+		while (excess_[node] > 0 && heights_[node] < max_height) {
+			if (path_id == degree) {
+				// Relabel the node to one more than its lowest residual neighbour
+				NodeType old_height = heights_[node];
+				NodeType new_height = 2 * num_nodes_;
+
+				for (NodeType neigh_id = begin; neigh_id < begin + degree; neigh_id++) {
+					NodeType edge_id = adj_edges_[neigh_id];
+
+					if (flows_[edge_id] < capacities_[edge_id] &&
+						heights_[heads_[edge_id]] + 1 < new_height) {
+						new_height = heights_[heads_[edge_id]] + 1;
+					}
+				}
+
+				work += degree + 12;
+				path_id = 0;
+				heights_[node] = new_height;
+
+				if (use_gap && old_height < num_nodes_) {
+					--height_counts_[old_height];
+
+					if (new_height < num_nodes_) {
+						++height_counts_[new_height];
+					}
+
+					if (height_counts_[old_height] == 0) {
+						// No node is left at old_height, so the nodes above it
+						// (this one included) cannot reach target either
+						for (NodeType v = 0; v < num_nodes_; ++v) {
+							if (heights_[v] > old_height && heights_[v] < num_nodes_) {
+								--height_counts_[heights_[v]];
+								heights_[v] = num_nodes_;
+							}
+						}
+					}
+				}
+
+				continue;
+			}
+
+			NodeType edge_id = adj_edges_[begin + path_id];
+			NodeType head = heads_[edge_id];
+			FlowType residual = capacities_[edge_id] - flows_[edge_id];
+
+			if (residual > 0 && heights_[node] == heights_[head] + 1) {
+				FlowType pushed_flow = excess_[node] < residual ? excess_[node] : residual;
+				touch_edge(edge_id);
+				flows_[edge_id] += pushed_flow;
+				flows_[edge_id ^ 1] -= pushed_flow;
+				excess_[node] -= pushed_flow;
+
+				if (excess_[head] == 0 && head != target && head != other) {
+					active.push(head);
+				}
+
+				excess_[head] += pushed_flow;
+			} else {
+				++path_id;
+			}
 		}
 	}
-	return total_flow;
 }
 
 void FlowNetwork::decompose_nodes_STU(NodePtr source, NodePtr sink) {
+	build_adjacency();
+	nodes_[source->get_id()] = source;
+	nodes_[sink->get_id()] = sink;
+
+	// The trees of the last decomposition are repaired if they are for the
+	// same source and sink in a network with the same nodes
+	bool full = decomposition_mode_ == FULL ||
+				S_parents_.size() != (std::size_t) num_nodes_ ||
+				decomposed_source_ != source->get_id() ||
+				decomposed_sink_ != sink->get_id();
+
 	// Find S nodes which are reachable from source in residual network
-	find_S_nodes(source);
+	update_tree(source->get_id(), false, S_parents_, S_order_, full);
 
 	// Find T nodes which can reach sink in residual network
-	find_T_nodes(sink);
+	update_tree(sink->get_id(), true, T_parents_, T_order_, full);
+
+	if (decomposition_mode_ == VERIFY && !full) {
+		std::vector<NodeType> S_parents, S_order, T_parents, T_order;
+		update_tree(source->get_id(), false, S_parents, S_order, true);
+		update_tree(sink->get_id(), true, T_parents, T_order, true);
+
+		for (NodeType node = 0; node < num_nodes_; ++node) {
+			if ((S_parents[node] == NO_EDGE) != (S_parents_[node] == NO_EDGE) ||
+				(T_parents[node] == NO_EDGE) != (T_parents_[node] == NO_EDGE)) {
+				throw std::runtime_error("incremental decomposition differs from the full one");
+			}
+		}
+	}
+
+	decomposed_source_ = source->get_id();
+	decomposed_sink_ = sink->get_id();
+
+	for (NodeType pair : touched_edges_) {
+		touched_[pair] = false;
+	}
+	touched_edges_.clear();
+
+	// T nodes are labelled after S nodes as before
+	std::vector<Node::DecompositionLabel> old_labels(num_nodes_, Node::LABEL_U);
+	old_labels.swap(labels_);
+
+	for (NodeType node : S_order_) {
+		labels_[node] = Node::LABEL_S;
+	}
+
+	for (NodeType node : T_order_) {
+		labels_[node] = Node::LABEL_T;
+	}
+
+	// Copy the labels to the nodes, and remember which ones changed
+	relabelled_nodes_.clear();
+	for (NodeType node = 0; node < num_nodes_; ++node) {
+		if (labels_[node] != old_labels[node]) {
+			changed_nodes_.push_back(node);
+			relabelled_nodes_.push_back(node);
+		}
+
+		if (nodes_[node]) {
+			nodes_[node]->set_decomposition_label(labels_[node]);
+		}
+	}
 }
 
 void FlowNetwork::get_residual_edges(EdgeList& residual_edges, EdgeList& reverse_edges) {
 	// Iterate through all edges
-	for (NodeType edge_id = 0; edge_id < (int)edges_.size(); ++edge_id) {
-		Edge& edge = edges_[edge_id];
-		Edge& reverse_edge = edges_[edge_id ^ 1];
-
-		// Check if edge is a residual edge
-		if (is_residual_edge(edge, reverse_edge)) {
-			residual_edges.push_back(edge);
-			reverse_edges.push_back(reverse_edge);
+	// Returns the edge with the given id as an Edge
+	auto make_edge = [this] (NodeType edge_id) {
+		Edge edge(nodes_[get_tail(edge_id)], nodes_[heads_[edge_id]],
+				  capacities_[edge_id], ranks_[edge_id]);
+		edge.set_flow(flows_[edge_id]);
+		return edge;
+	};
+
+	for_each_residual_arc([&] (NodeType edge_id) {
+		residual_edges.push_back(make_edge(edge_id));
+		reverse_edges.push_back(make_edge(edge_id ^ 1));
+	});
+}
+
+FlowType FlowNetwork::compute_min_cost_flow(NodePtr source, NodePtr sink, CostType& cost) {
+	build_adjacency();
+	nodes_[source->get_id()] = source;
+	nodes_[sink->get_id()] = sink;
+
+	init_potentials(source->get_id());
+
+	FlowType total_flow = 0;
+
+	// Augment along a cheapest path while there is one, the flow stays of
+	// minimum cost for its value
+	while (shortest_path(source->get_id(), sink->get_id())) {
+		FlowType pushed_flow = std::numeric_limits<FlowType>::max();
+
+		for (NodeType node = sink->get_id(); node != source->get_id(); node = get_tail(pred_edges_[node])) {
+			NodeType edge_id = pred_edges_[node];
+			pushed_flow = std::min(pushed_flow, capacities_[edge_id] - flows_[edge_id]);
+		}
+
+		for (NodeType node = sink->get_id(); node != source->get_id(); node = get_tail(pred_edges_[node])) {
+			NodeType edge_id = pred_edges_[node];
+			touch_edge(edge_id);
+			flows_[edge_id] += pushed_flow;
+			flows_[edge_id ^ 1] -= pushed_flow;
+			cost += pushed_flow * get_cost(edge_id);
 		}
+
+		total_flow += pushed_flow;
 	}
+
+	return total_flow;
 }
 
-bool FlowNetwork::path_between(NodeType source, NodeType sink) {
-	// Perform a bfs from the source
-	std::queue<NodeType> bfs_queue;
-	bfs_queue.push(source);
+FlowType FlowNetwork::compute_feasible_circulation(NodePtr super_source, NodePtr super_sink) {
+	lower_inflows_.resize(num_nodes_, 0);
+
+	// A node receiving more lower bound flow than it sends has to pass the
+	// difference on, and the circulation exists iff every edge from the
+	// super source is saturated
+	FlowType demand = 0;
+	for (NodeType node = 0; node < num_nodes_; ++node) {
+		if (lower_inflows_[node] > 0) {
+			add_edge(super_source, nodes_[node], lower_inflows_[node], 0);
+			demand += lower_inflows_[node];
+		} else if (lower_inflows_[node] < 0) {
+			add_edge(nodes_[node], super_sink, -lower_inflows_[node], 0);
+		}
+	}
 
-	// Initialise all distances from source to num_nodes + 1
-	fill(dist_.begin(), dist_.end(), num_nodes_ + 1);
+	return demand - compute_max_flow(super_source, super_sink);
+}
 
-	// Set distance of source as 0
-	dist_[source] = 0;
+CostType FlowNetwork::get_cost(NodeType edge_id) const {
+	return (edge_id & 1) ? -(CostType) ranks_[edge_id ^ 1] : ranks_[edge_id];
+}
 
-	// Iterate while there are more nodes reachable from source
-	while (!bfs_queue.empty()) {
-		NodeType node = bfs_queue.front();
-		bfs_queue.pop();
+void FlowNetwork::init_potentials(NodeType source) {
+	potentials_.assign(num_nodes_, 0);
+	cost_dist_.assign(num_nodes_, std::numeric_limits<CostType>::max());
+	pred_edges_.assign(num_nodes_, NO_EDGE);
+	reached_.clear();
 
-		// On reaching sink, we have a path from source to sink
-		if (node == sink) {
+	bool negative = false;
+	for (NodeType edge_id = 0; edge_id < (NodeType) heads_.size() && !negative; ++edge_id) {
+		negative = get_cost(edge_id) < 0 && is_residual_edge(edge_id);
+	}
+
+	// The zero potentials will do if no residual edge has a negative cost
+	if (!negative) {
+		return;
+	}
+
+	// Bellman-Ford with a queue, the nodes which are not reachable from the
+	// source now never become reachable so their potentials do not matter
+	std::vector<char> queued(num_nodes_, false);
+	std::queue<NodeType> bf_queue;
+	cost_dist_[source] = 0;
+	bf_queue.push(source);
+
+	while (!bf_queue.empty()) {
+		NodeType node = bf_queue.front();
+		bf_queue.pop();
+		queued[node] = false;
+
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			NodeType head = heads_[edge_id];
+
+			if (flows_[edge_id] < capacities_[edge_id] &&
+				cost_dist_[node] + get_cost(edge_id) < cost_dist_[head]) {
+				cost_dist_[head] = cost_dist_[node] + get_cost(edge_id);
+
+				if (!queued[head]) {
+					queued[head] = true;
+					bf_queue.push(head);
+				}
+			}
+		}
+	}
+
+	for (NodeType node = 0; node < num_nodes_; ++node) {
+		if (cost_dist_[node] != std::numeric_limits<CostType>::max()) {
+			potentials_[node] = cost_dist_[node];
+			cost_dist_[node] = std::numeric_limits<CostType>::max();
+		}
+	}
+}
+
+bool FlowNetwork::shortest_path(NodeType source, NodeType sink) {
+	const CostType infinity = std::numeric_limits<CostType>::max();
+
+	for (NodeType node : reached_) {
+		cost_dist_[node] = infinity;
+	}
+	reached_.clear();
+
+	typedef std::pair<CostType, NodeType> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> heap;
+	cost_dist_[source] = 0;
+	reached_.push_back(source);
+	heap.push(std::make_pair(0, source));
+
+	// The search stops when the sink is taken from the heap, the nodes left
+	// in it are at least as far as the sink
+	while (!heap.empty()) {
+		CostType node_dist = heap.top().first;
+		NodeType node = heap.top().second;
+		heap.pop();
+
+		if (node_dist != cost_dist_[node]) {
+			continue;
+		} else if (node == sink) {
 			break;
 		}
 
-		// Iterate through neighbours of the node
-		for (NodeType neigh_id = 0; neigh_id < (int)adj_list_[node].size(); neigh_id++) {
-			NodeType neigh_node = adj_list_[node][neigh_id];
-			Edge &edge = edges_[neigh_node];
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			NodeType head = heads_[edge_id];
+
+			if (flows_[edge_id] < capacities_[edge_id]) {
+				CostType head_dist = node_dist + get_cost(edge_id) + potentials_[node] - potentials_[head];
 
-			// Check if more flow can be sent through the edge
-			if ((edge.get_flow() < edge.get_capacity()) && 
-				(dist_[edge.get_V()->get_id()] > dist_[edge.get_U()->get_id()] + 1)) {
-				dist_[edge.get_V()->get_id()] = dist_[edge.get_U()->get_id()] + 1;
-				bfs_queue.push(edge.get_V()->get_id());
+				if (head_dist < cost_dist_[head]) {
+					if (cost_dist_[head] == infinity) {
+						reached_.push_back(head);
+					}
+
+					cost_dist_[head] = head_dist;
+					pred_edges_[head] = edge_id;
+					heap.push(std::make_pair(head_dist, head));
+				}
 			}
 		}
 	}
 
+	if (cost_dist_[sink] == infinity) {
+		return false;
+	}
+
+	// Adding min(dist, dist of the sink) to every potential keeps the reduced
+	// costs non-negative and makes those on the path zero, the nodes which
+	// were not reached get the distance of the sink, which is the same as
+	// subtracting it from the potentials of the nodes reached
+	for (NodeType node : reached_) {
+		potentials_[node] += std::min(cost_dist_[node], cost_dist_[sink]) - cost_dist_[sink];
+	}
+
+	return true;
+}
+
+bool FlowNetwork::path_between(NodeType source, NodeType sink) {
+	// The search stops after the level of the sink, the nodes further away
+	// cannot be on a shortest path
+	level_bfs(source, sink, false, dist_, bfs_order_);
+
 	// Return if the sink has been reached from the source
 	return (dist_[sink] != num_nodes_ + 1);
 }
 
-
-FlowType FlowNetwork::send_flow(NodeType source, NodeType sink, FlowType flow /* = -1 */) {
-	// Sending flow is complete when the current node is destination node
-	// or if there is no flow to be sent through the path
-	if (source == sink || flow == 0) {
-		return flow;
+void FlowNetwork::level_bfs(NodeType root, NodeType target, bool reverse,
+							std::vector<NodeType>& dist, std::vector<NodeType>& order) {
+	const NodeType unreached = num_nodes_ + 1;
+
+	// A node is claimed by the thread which sets its bit, the bitmap is
+	// kept between the searches of all the phases
+	if (!visited_) {
+		NodeType nwords = (num_nodes_ + 63) / 64;
+		visited_.reset(new std::atomic<std::uint64_t>[nwords]);
+		for (NodeType i = 0; i < nwords; ++i) {
+			visited_[i].store(0, std::memory_order_relaxed);
+		}
 	}
 
-	// Iterate through the neighbours which have not yet been traversed
-	for (NodeType &path_id = path_to_traverse_[source];
-		 path_id < (int)adj_list_[source].size(); ++path_id) {
-		Edge &edge = edges_[adj_list_[source][path_id]];
+	std::atomic<std::uint64_t>* visited = visited_.get();
+
+	auto visit = [visited] (NodeType node) {
+		std::uint64_t bit = std::uint64_t(1) << (node & 63);
+		return !(visited[node >> 6].fetch_or(bit, std::memory_order_relaxed) & bit);
+	};
+
+	auto is_visited = [visited] (NodeType node) {
+		return (visited[node >> 6].load(std::memory_order_relaxed) >> (node & 63)) & 1;
+	};
+
+	auto degree = [this] (NodeType node) -> long {
+		return adj_offsets_[node + 1] - adj_offsets_[node];
+	};
+
+	dist.assign(num_nodes_, unreached);
+	order.clear();
+	dist[root] = 0;
+	visit(root);
+	order.push_back(root);
+
+	// The level being expanded is order[begin, order.size())
+	std::size_t begin = 0;
+	long level_edges = degree(root);
+	long unvisited_edges = (long) adj_edges_.size() - level_edges;
+	bool bottom_up = false;
 
-		// Check if the edge (u,v) is an edge in the bfs tree
-		if (dist_[edge.get_V()->get_id()] == dist_[edge.get_U()->get_id()] + 1) {
-			// Compute limiting flow as minimum flow across all edges in the path
-			FlowType limiting_flow = edge.get_capacity() - edge.get_flow();
-			if (flow != -1 && limiting_flow > flow) {
-				limiting_flow = flow;
+	for (NodeType level = 0; begin < order.size(); ++level) {
+		if (target != -1 && dist[target] != unreached) {
+			break;
+		}
+
+		std::size_t end = order.size();
+		NodeType level_size = end - begin;
+
+		if (!bottom_up && level_edges > unvisited_edges / BOTTOM_UP_ALPHA) {
+			bottom_up = true;
+		} else if (bottom_up && level_size < num_nodes_ / BOTTOM_UP_BETA) {
+			bottom_up = false;
+		}
+
+		// Every block collects the nodes it reaches, which are appended to
+		// order in the order of the blocks, a level smaller than
+		// PARALLEL_GRAIN_SIZE is a single block expanded by this thread
+		IndexType range = bottom_up ? num_nodes_ : level_size;
+		auto& found = bfs_found_;
+		found.resize(std::max<std::size_t>(found.size(), parallel_blocks(range)));
+		for (auto& block_found : found) {
+			block_found.clear();
+		}
+
+		std::vector<long> found_edges(found.size(), 0);
+
+		if (bottom_up) {
+			in_frontier_.resize(num_nodes_, false);
+			for (std::size_t i = begin; i < end; ++i) {
+				in_frontier_[order[i]] = true;
 			}
 
-			// Recursively send the limiting flow from v to the destination
-			if (FlowType pushed_flow = send_flow(edge.get_V()->get_id(), sink, limiting_flow)) {
-				// Increment the flow of the edge (u,v) by the pushed flow
-				edge.set_flow(edge.get_flow() + pushed_flow);
+			// A node joins the next level if it has a residual edge from (or
+			// to if reverse) a node of this level
+			parallel_for(range, [&] (unsigned block, IndexType first, IndexType last) {
+				for (NodeType node = first; node < (NodeType) last; ++node) {
+					if (is_visited(node)) {
+						continue;
+					}
+
+					for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+						NodeType edge_id = adj_edges_[neigh_id];
+						NodeType arc = reverse ? edge_id : edge_id ^ 1;
+
+						if (in_frontier_[heads_[edge_id]] && flows_[arc] < capacities_[arc]) {
+							visit(node);
+							dist[node] = level + 1;
+							found[block].push_back(node);
+							found_edges[block] += degree(node);
+							break;
+						}
+					}
+				}
+			});
 
-				// Decrement the flow of the reverse  edge by the pushed flow
-				Edge &reverse_edge = edges_[adj_list_[source][path_id] ^ 1];
-				reverse_edge.set_flow(reverse_edge.get_flow() - pushed_flow);
-				
-				return pushed_flow;
+			for (std::size_t i = begin; i < end; ++i) {
+				in_frontier_[order[i]] = false;
 			}
+		} else {
+			// Every node of this level claims the nodes it reaches first
+			parallel_for(range, [&] (unsigned block, IndexType first, IndexType last) {
+				for (std::size_t i = begin + first; i < begin + last; ++i) {
+					NodeType node = order[i];
+
+					for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+						NodeType edge_id = adj_edges_[neigh_id];
+						NodeType head = heads_[edge_id];
+						NodeType arc = reverse ? edge_id ^ 1 : edge_id;
+
+						if (flows_[arc] < capacities_[arc] && !is_visited(head) && visit(head)) {
+							dist[head] = level + 1;
+							found[block].push_back(head);
+							found_edges[block] += degree(head);
+						}
+					}
+				}
+			});
 		}
+
+		level_edges = 0;
+		for (std::size_t block = 0; block < found.size(); ++block) {
+			order.insert(order.end(), found[block].begin(), found[block].end());
+			level_edges += found_edges[block];
+		}
+
+		unvisited_edges -= level_edges;
+		begin = end;
+	}
+
+	// Every node set in the bitmap is in order
+	for (auto node : order) {
+		visited[node >> 6].store(0, std::memory_order_relaxed);
 	}
-	return 0;
 }
 
-void FlowNetwork::find_S_nodes(NodePtr source) {
-	// Perform a bfs from the source on the residual network
-	std::queue<NodePtr> bfs_queue;
-	bfs_queue.push(source);
-	
-	// Initialise all nodes as unvisited (0)
-	fill(dist_.begin(), dist_.end(), 0);
-	
-	// Mark source as visited
-	dist_[source->get_id()] = 1;
-
-	// Iterate while there are more nodes reachable from
-	// source in the residual network
-	while (!bfs_queue.empty()) {
-		NodePtr node = bfs_queue.front();
-		bfs_queue.pop();
-		
-		// Set the decomposition label as S
-		node->set_decomposition_label("S");
-		
-		// Iterate through neighbours of the node
-		for (NodeType neigh_id = 0; neigh_id < (int)adj_list_[node->get_id()].size(); neigh_id++) {
-			NodeType neigh_node = adj_list_[node->get_id()][neigh_id];
-			Edge &edge = edges_[neigh_node];
-			Edge &reverse_edge = edges_[neigh_node ^ 1];
-			
-			// Check if edge (u,v) is a residual edge
-			if (is_residual_edge(edge, reverse_edge)) {
-				// Check that node v is unvisited
-				if (dist_[edge.get_V()->get_id()] == 0) {
-					// Mark node v as visited
-					dist_[edge.get_V()->get_id()] = 1;
-					bfs_queue.push(edge.get_V());
+
+FlowType FlowNetwork::send_flow(NodeType source, NodeType sink) {
+	FlowType total_flow = 0;
+	NodeType node = source;
+
+	// path_edges_ holds the edges of the current path from the source, and
+	// path_limits_[i] the least residual capacity of the first i + 1 edges
+	path_edges_.clear();
+	path_limits_.clear();
+
+	while (true) {
+		if (node == sink) {
+			// Push the limiting flow along the whole path, and retreat to the
+			// tail of the first edge that it saturates
+			FlowType pushed_flow = path_limits_.back();
+			NodeType saturated = -1;
+			total_flow += pushed_flow;
+
+			for (NodeType i = 0; i < (int)path_edges_.size(); ++i) {
+				NodeType edge_id = path_edges_[i];
+				touch_edge(edge_id);
+				flows_[edge_id] += pushed_flow;
+				flows_[edge_id ^ 1] -= pushed_flow;
+				path_limits_[i] -= pushed_flow;
+
+				if (saturated == -1 && flows_[edge_id] == capacities_[edge_id]) {
+					saturated = i;
 				}
 			}
+
+			node = get_tail(path_edges_[saturated]);
+			path_edges_.resize(saturated);
+			path_limits_.resize(saturated);
+			continue;
+		}
+
+		// Advance along the first edge of the bfs tree which is not yet
+		// traversed and has residual capacity
+		NodeType begin = adj_offsets_[node];
+		NodeType degree = adj_offsets_[node + 1] - begin;
+		NodeType &path_id = path_to_traverse_[node];
+
+		for (; path_id < degree; ++path_id) {
+			NodeType edge_id = adj_edges_[begin + path_id];
+			FlowType residual = capacities_[edge_id] - flows_[edge_id];
+
+			if (residual > 0 && dist_[heads_[edge_id]] == dist_[node] + 1) {
+				// On unit capacity paths the limit stays at 1 once reached
+				FlowType limit = residual;
+				if (!path_limits_.empty() && path_limits_.back() < limit) {
+					limit = path_limits_.back();
+				}
+
+				path_edges_.push_back(edge_id);
+				path_limits_.push_back(limit);
+				node = heads_[edge_id];
+				break;
+			}
+		}
+
+		if (path_id == degree) {
+			// The node is a dead end, retreat and skip the edge leading to it
+			if (node == source) {
+				break;
+			}
+
+			node = get_tail(path_edges_.back());
+			path_edges_.pop_back();
+			path_limits_.pop_back();
+			++path_to_traverse_[node];
 		}
 	}
-}
 
-void FlowNetwork::find_T_nodes(NodePtr sink) {
-	// Perform a bfs from the sink on the reverse residual network
-	std::queue<NodePtr> bfs_queue;
-	bfs_queue.push(sink);
-	
-	// Initialise all nodes as unvisited (0)
-	fill(dist_.begin(), dist_.end(), 0);
-	
-	// Mark sink as visited
-	dist_[sink->get_id()] = 1;
-	
-	// Iterate while there are more nodes reachable from
-	// sink in the reverse residual network
-	while (!bfs_queue.empty()) {
-		NodePtr node = bfs_queue.front();
-		bfs_queue.pop();
+	return total_flow;
+}
 
-		// Set the decomposition label as T
-		node->set_decomposition_label("T");
-
-		// Iterate through neighbours of the node
-		for (NodeType neigh_id = 0; neigh_id < (int)adj_list_[node->get_id()].size(); neigh_id++) {
-			NodeType neigh_node = adj_list_[node->get_id()][neigh_id];
-			Edge& edge = edges_[neigh_node];
-			Edge &reverse_edge = edges_[neigh_node ^ 1];
-			
-			// Check if the reverse edge (v,u) is a residual edge
-			if (is_residual_edge(reverse_edge, edge)) {
-				// Check that v is unvisited
-				if (dist_[edge.get_V()->get_id()] != 1) {
-					// Mark node v as visited
-					dist_[edge.get_V()->get_id()] = 1;
-					bfs_queue.push(edge.get_V());
+void FlowNetwork::update_tree(NodeType root, bool reverse, std::vector<NodeType>& parents,
+							  std::vector<NodeType>& order, bool full) {
+	// A node of the S tree is reached through a residual edge from its
+	// parent, and a node of the T tree (reverse) through one to its parent
+	auto parent_of = [this, reverse] (NodeType edge_id) {
+		return reverse ? heads_[edge_id] : get_tail(edge_id);
+	};
+
+	if (full) {
+		level_bfs(root, -1, reverse, dist_, order);
+
+		// The parent of a node is the first node one level closer to the
+		// root in its adjacency, so the trees do not depend on the threads
+		parents.assign(num_nodes_, NO_EDGE);
+		parents[root] = ROOT_EDGE;
+
+		parallel_for(order.size(), [&] (unsigned, IndexType first, IndexType last) {
+			for (IndexType i = std::max<IndexType>(first, 1); i < last; ++i) {
+				NodeType node = order[i];
+
+				for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+					NodeType edge_id = adj_edges_[neigh_id];
+					NodeType tree_edge = reverse ? edge_id : edge_id ^ 1;
+
+					if (dist_[heads_[edge_id]] + 1 == dist_[node] && is_residual_edge(tree_edge)) {
+						parents[node] = tree_edge;
+						break;
+					}
 				}
 			}
+		});
+
+		return;
+	}
+
+	// Drop the nodes whose path to the root lost its residual capacity,
+	// a parent comes before its children in order
+	std::vector<NodeType> dropped;
+	std::size_t kept = 0;
+
+	for (NodeType node : order) {
+		NodeType edge_id = parents[node];
+
+		if (edge_id != ROOT_EDGE &&
+			(parents[parent_of(edge_id)] == NO_EDGE || !is_residual_edge(edge_id))) {
+			parents[node] = NO_EDGE;
+			dropped.push_back(node);
+		} else {
+			order[kept++] = node;
 		}
 	}
-}
 
-bool FlowNetwork::is_edge_label(Edge& edge, IdType decomposition_label_u,
-							    IdType decomposition_label_v) {
-	// Return if u has label decomposition_label_u and 
-	// v has label decomposition_label_v
-	return (edge.get_U()->get_decomposition_label() == decomposition_label_u &&
-	        edge.get_V()->get_decomposition_label() == decomposition_label_v);
+	order.resize(kept);
+	std::size_t first_new = kept;
+
+	auto attach = [&] (NodeType node, NodeType edge_id) {
+		if (parents[node] == NO_EDGE && parents[parent_of(edge_id)] != NO_EDGE &&
+			is_residual_edge(edge_id)) {
+			parents[node] = edge_id;
+			order.push_back(node);
+		}
+	};
+
+	// A dropped node may be reached again through another node of the tree
+	for (NodeType node : dropped) {
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			attach(node, reverse ? edge_id : edge_id ^ 1);
+		}
+	}
+
+	// Any other new node is behind an edge which changed
+	for (NodeType pair : touched_edges_) {
+		for (NodeType edge_id = 2 * pair; edge_id <= 2 * pair + 1; ++edge_id) {
+			attach(reverse ? get_tail(edge_id) : heads_[edge_id], edge_id);
+		}
+	}
+
+	// Perform a bfs from the new nodes of the tree, there are few of them
+	// unless many edges changed
+	for (std::size_t i = first_new; i < order.size(); ++i) {
+		NodeType node = order[i];
+
+		for (NodeType neigh_id = adj_offsets_[node]; neigh_id < adj_offsets_[node + 1]; neigh_id++) {
+			NodeType edge_id = adj_edges_[neigh_id];
+			NodeType head = heads_[edge_id];
+			NodeType tree_edge = reverse ? edge_id ^ 1 : edge_id;
+
+			// Check if the edge towards or from the tree is a residual edge
+			if (parents[head] == NO_EDGE && is_residual_edge(tree_edge)) {
+				parents[head] = tree_edge;
+				order.push_back(head);
+			}
+		}
+	}
 }
 
-bool FlowNetwork::is_residual_edge(Edge& edge, Edge& reverse_edge) {
+bool FlowNetwork::is_residual_edge(NodeType edge_id) const {
 	// If edge is a forward edge, residual edge exists if flow < capacity
-	if (edge.get_flow() < edge.get_capacity()) {
+	if (flows_[edge_id] < capacities_[edge_id]) {
 		return true;
 	}
 
 	// If edge is a reverse edge, residual edge exists if reverse flow > 0
-	if (reverse_edge.get_flow() > 0) {
+	if (flows_[edge_id ^ 1] > 0) {
 		return true;
 	}
 
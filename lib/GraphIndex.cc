@@ -0,0 +1,107 @@
+#include "GraphIndex.h"
+#include "Vertex.h"
+#include "PreferenceList.h"
+
+const RankType GraphIndex::UNRANKED;
+
+GraphIndex::GraphIndex(const BipartiteGraph& G)
+    : G_(G)
+{
+    const auto& A = G.get_A_vertices();
+    const auto& B = G.get_B_vertices();
+
+    A_offsets_.reserve(A.size() + 1);
+    A_offsets_.emplace_back(0);
+
+    // the edges are read from the preference lists of vertices in A
+    for (const auto& a : A) {
+        auto& pref_list = a->get_preference_list();
+
+        for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+            auto b = pref_list.get_vertex(*i);
+
+            // ignore vertices which do not belong to this graph
+            if (is_B_vertex(b)) {
+                tails_.emplace_back(a->get_index());
+                heads_.emplace_back(b->get_index());
+                A_ranks_.emplace_back(pref_list.get_rank(*i));
+            }
+        }
+
+        A_offsets_.emplace_back(heads_.size());
+        A_quotas_.emplace_back(a->get_upper_quota());
+    }
+
+    for (const auto& b : B) {
+        B_quotas_.emplace_back(b->get_upper_quota());
+    }
+
+    // group the edges by their endpoint in B (counting sort on the heads)
+    B_offsets_.assign(B.size() + 1, 0);
+    for (auto b : heads_) {
+        ++B_offsets_[b+1];
+    }
+
+    for (IndexType b = 0; b < B.size(); ++b) {
+        B_offsets_[b+1] += B_offsets_[b];
+    }
+
+    IndexListType next(B_offsets_.begin(), B_offsets_.end() - 1);
+    B_edges_.resize(heads_.size());
+    for (IndexType e = 0; e < heads_.size(); ++e) {
+        B_edges_[next[heads_[e]]++] = e;
+    }
+
+    // the rank of a on the preference list of b, edge_of[a] is the edge (a, b)
+    // while the edges of b are being looked at
+    B_ranks_.assign(heads_.size(), UNRANKED);
+    IndexListType edge_of(A.size(), num_edges());
+
+    for (const auto& b : B) {
+        auto bi = b->get_index();
+        auto& pref_list = b->get_preference_list();
+
+        for (auto i = B_begin(bi), ie = B_end(bi); i != ie; ++i) {
+            edge_of[tails_[B_edges_[i]]] = B_edges_[i];
+        }
+
+        for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+            auto a = pref_list.get_vertex(*i);
+
+            if (is_A_vertex(a) and edge_of[a->get_index()] != num_edges()) {
+                B_ranks_[edge_of[a->get_index()]] = pref_list.get_rank(*i);
+            }
+        }
+
+        for (auto i = B_begin(bi), ie = B_end(bi); i != ie; ++i) {
+            edge_of[tails_[B_edges_[i]]] = num_edges();
+        }
+    }
+}
+
+GraphIndex::~GraphIndex()
+{}
+
+const BipartiteGraph& GraphIndex::get_graph() const {
+    return G_;
+}
+
+bool GraphIndex::is_A_vertex(const VertexPtr& v) const {
+    const auto& A = G_.get_A_vertices();
+    return v->get_graph() == &G_ and v->get_index() < A.size() and A[v->get_index()] == v;
+}
+
+bool GraphIndex::is_B_vertex(const VertexPtr& v) const {
+    const auto& B = G_.get_B_vertices();
+    return v->get_graph() == &G_ and v->get_index() < B.size() and B[v->get_index()] == v;
+}
+
+IndexType GraphIndex::find_edge(IndexType a, IndexType b) const {
+    for (auto e = A_begin(a), ee = A_end(a); e != ee; ++e) {
+        if (heads_[e] == b) {
+            return e;
+        }
+    }
+
+    return num_edges();
+}
@@ -5,6 +5,7 @@
 #include "PartnerList.h"
 #include "TDefs.h"
 #include "Utils.h"
+#include "ReducedGraphCache.h"
 #include <stack>
 #include <algorithm>
 #include <cassert>
@@ -55,7 +56,8 @@ bool HHeuristicHRLQ::compute_matching() {
         } else {
             // for (int s = 2; s < send; s += 2) {
             int s = send;
-            G2_ = augment_phase2(M, s);
+            G2_ = G->get_reduced_graphs().get("hheuristic-phase2", s,
+                                              [this, s] { return augment_phase2(s); });
             compute_phase2_matching(M, def, s);
             //if (not G2_->has_augmenting_path(M_tmp_)) {
             const auto& M_inv = map_inverse(M_tmp_);
@@ -86,8 +88,20 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
     std::map<IdType, int> in_queue;
 
     // partitions of the graph G2_
-    const auto& A = G2_->get_A_partition();
-    const auto& B = G2_->get_B_partition();
+    const auto& A = (*G2_)->get_A_partition();
+    const auto& B = (*G2_)->get_B_partition();
+
+    // proposal index of the hospitals in G2_, by their index, G2_ is shared
+    // through the cache of G and hence its preference lists are not modified
+    std::vector<PreferenceList::SizeType> proposal_index(B.size());
+    for (auto it : B) {
+        proposal_index[it.second->get_index()] = it.second->get_preference_list().begin();
+    }
+
+    // have the preferences of hospital u been exhausted
+    auto is_exhausted = [&proposal_index] (const VertexPtr& u) {
+        return proposal_index[u->get_index()] >= u->get_preference_list().end();
+    };
 
     // original graph G
     const std::unique_ptr<BipartiteGraph>& G = get_graph();
@@ -161,13 +175,14 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
         auto& u_pref_list = u->get_preference_list();
         auto& u_partner_list = M_tmp_[u];
         auto const& pu_id = u->get_cloned_for_id();
+        auto& u_proposal_index = proposal_index[u->get_index()];
         free_list.pop(); // remove u from free_list
         in_queue[pu_id] = 0;
 
         // if the preferences of u have not been exhausted
-        if (not u_pref_list.empty()) {
+        if (not is_exhausted(u)) {
             // highest ranked vertex to whom u not yet proposed
-            auto v = u_pref_list.get_vertex(u_pref_list.get_proposal_index());
+            auto v = u_pref_list.get_vertex(u_proposal_index);
 
             // v's preference list and list of partners
             auto& v_pref_list = v->get_preference_list();
@@ -177,7 +192,7 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
             auto u_rank = v_pref_list.get_rank(v_pref_list.find(u));
 
             // v's rank on u's preference list
-            auto v_rank = u_pref_list.get_rank(u_pref_list.get_proposal_index());
+            auto v_rank = u_pref_list.get_rank(u_proposal_index);
 
             if (v_partner_list.size() == v->get_upper_quota()) {
                 // v's least preferred partner
@@ -186,7 +201,6 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
                 // worst partners rank, and preference list
                 auto uc = v_partner_list.get_vertex(worst_partner);
                 auto uc_rank = v_partner_list.get_rank(worst_partner);
-                auto& uc_pref_list = uc->get_preference_list();
                 auto& uc_partner_list = M_tmp_[uc];
 
                 // does v prefer u over its worst partner?
@@ -219,7 +233,7 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
                             // push uc to free list
                             free_list.push(uc);
                             in_queue[puc_id] = 1;
-                        } else if (uc_level == 0 and not uc_pref_list.empty()
+                        } else if (uc_level == 0 and not is_exhausted(uc)
                                 and uc->get_upper_quota() > nmatched_count[puc_id])
                         {
                             free_list.push(uc);
@@ -229,7 +243,7 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
                         assert(uc_level == 0 && "hospital is non lq but level is not 0");
 
                         if (in_queue[puc_id] == 0
-                            and not uc_pref_list.empty()
+                            and not is_exhausted(uc)
                             and uc->get_upper_quota() > nmatched_count[puc_id])
                         {
                             free_list.push(uc);
@@ -257,13 +271,13 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
                 if (in_queue[pu_id] == 1) {
                     // do nothing
                 } else if (def[pu_id] > 0) {
-                    u_pref_list.move_proposal_index();
+                    ++u_proposal_index;
                     free_list.push(u);
                     in_queue[pu_id] = 1;
-                } else if (u_level == 0 and not u_pref_list.empty()
+                } else if (u_level == 0 and not is_exhausted(u)
                         and u->get_upper_quota() > nmatched_count[pu_id])
                 {
-                    u_pref_list.move_proposal_index();
+                    ++u_proposal_index;
                     free_list.push(u);
                     in_queue[pu_id] = 1;
                 }
@@ -271,10 +285,10 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
                 assert(u_level == 0 && "hospital is non lq but level is not 0");
 
                 if (in_queue[pu_id] == 0
-                     and not u_pref_list.empty()
+                     and not is_exhausted(u)
                     and u->get_upper_quota() > nmatched_count[pu_id])
                 {
-                    u_pref_list.move_proposal_index();
+                    ++u_proposal_index;
                     free_list.push(u);
                     in_queue[pu_id] = 1;
                 }
@@ -294,10 +308,11 @@ bool HHeuristicHRLQ::compute_phase2_matching(const MatchedPairListType& M,
     return true;
 }
 
-std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPairListType& M, int s) {
+std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(int s) {
     BipartiteGraph::ContainerType A, B;
     const std::unique_ptr<BipartiteGraph>& G = get_graph();
-    std::map<IdType, std::vector<IdType>> lq_map; // lq hospitals for a resident
+    // lq hospitals for a resident, with their ranks on its list
+    std::map<IdType, std::vector<std::pair<IdType, RankType>>> lq_map;
 
     // first add vertices from partition A
     for (auto it : G->get_A_partition()) {
@@ -307,13 +322,14 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
         auto& v_pref_list = v->get_preference_list();
         auto u = std::make_shared<Vertex>(v_id,
                         v->get_lower_quota(), v->get_upper_quota());
+        u->set_origin(v, 0);
 
         for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end(); i != e; ++i) {
             auto h = v_pref_list.get_vertex(*i);
 
             // only add lower quota vertices
             if (h->get_lower_quota() > 0) {
-                lq_map[v_id].emplace_back(h->get_id());
+                lq_map[v_id].emplace_back(h->get_id(), v_pref_list.get_rank(*i));
             }
         }
 
@@ -333,7 +349,7 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
                 const auto& u_id = get_vertex_id(v_id, k);
                 auto u = std::make_shared<Vertex>(u_id, v_id,
                             v->get_lower_quota(), v->get_upper_quota(), false);
-                auto& u_pref_list = u->get_preference_list();
+                u->set_origin(v, k);
 
                 // add this vertex to partition B
                 B.emplace(u_id, u);
@@ -344,7 +360,8 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
                      i != e; ++i)
                 {
                     auto neighbour = v_pref_list.get_vertex(*i);
-                    u_pref_list.emplace_back(A.at(neighbour->get_id()));
+                    u->emplace_back_with_origin(A.at(neighbour->get_id()),
+                                                v_pref_list.get_rank(*i));
                 }
             }
         }
@@ -353,13 +370,13 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
         const auto& u_id = get_vertex_id(v_id, 0);
         auto u = std::make_shared<Vertex>(u_id, v_id,
                           v->get_lower_quota(), v->get_upper_quota(), false);
-        auto& u_pref_list = u->get_preference_list();
+        u->set_origin(v, 0);
 
         // for a level-0 hospital, its preference is the same
         // as the original preference list
         for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end(); i != e; ++i) {
             auto neighbour = v_pref_list.get_vertex(*i);
-            u_pref_list.emplace_back(A.at(neighbour->get_id()));
+            u->emplace_back_with_origin(A.at(neighbour->get_id()), v_pref_list.get_rank(*i));
         }
 
         // add this vertex to partition B
@@ -374,15 +391,14 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
 
         // create the preference list for the corresponding vertex in G_
         auto v_new = A.at(v_id);
-        auto& pref_list = v_new->get_preference_list();
 
         // the preference list of this vertex is all the
         // level-(s-1) lq hospitals, followed by level-(s-2) lq hospitals
         // in the same order as the original preference list
         for (int k = s; k > 0; --k) {
-            for (auto lq_id : lq_map[v_id]) {
-                const auto& u_k_id = get_vertex_id(lq_id, k);
-                pref_list.emplace_back(B.at(u_k_id));
+            for (const auto& lq : lq_map[v_id]) {
+                const auto& u_k_id = get_vertex_id(lq.first, k);
+                v_new->emplace_back_with_origin(B.at(u_k_id), lq.second);
             }
         }
 
@@ -391,7 +407,7 @@ std::unique_ptr<BipartiteGraph> HHeuristicHRLQ::augment_phase2(const MatchedPair
         for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end(); i != e; ++i) {
             auto u = v_pref_list.get_vertex(*i);
             const auto& u_0_id = get_vertex_id(u->get_id(), 0);
-            pref_list.emplace_back(B.at(u_0_id));
+            v_new->emplace_back_with_origin(B.at(u_0_id), v_pref_list.get_rank(*i));
         }
     }
 
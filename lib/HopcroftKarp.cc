@@ -0,0 +1,301 @@
+#include "HopcroftKarp.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include <limits>
+
+const IndexType HopcroftKarp::INFINITE_LEVEL = std::numeric_limits<IndexType>::max();
+
+HopcroftKarp::HopcroftKarp(const BipartiteGraph& G)
+    : index_(G),
+      matched_(index_.num_edges(), false),
+      A_level_(index_.num_A_vertices()), B_level_(index_.num_B_vertices()),
+      A_visited_(index_.num_A_vertices()), B_visited_(index_.num_B_vertices()),
+      A_arc_(index_.num_A_vertices()), B_arc_(index_.num_B_vertices()),
+      sink_level_(INFINITE_LEVEL), cardinality_(0)
+{
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        A_residual_.emplace_back(index_.get_A_quota(a));
+    }
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        B_residual_.emplace_back(index_.get_B_quota(b));
+    }
+}
+
+HopcroftKarp::~HopcroftKarp()
+{}
+
+const GraphIndex& HopcroftKarp::get_index() const {
+    return index_;
+}
+
+void HopcroftKarp::set_matching(const MatchedPairListType& M) {
+    // start with an empty matching
+    matched_.assign(index_.num_edges(), false);
+    cardinality_ = 0;
+
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        A_residual_[a] = index_.get_A_quota(a);
+    }
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        B_residual_[b] = index_.get_B_quota(b);
+    }
+
+    // it is enough to look at the partners of vertices in A
+    for (const auto& it : M) {
+        const auto& u = it.first;
+
+        if (index_.is_A_vertex(u)) {
+            const auto& partners = it.second;
+            auto a = u->get_index();
+
+            for (auto i = partners.cbegin(), e = partners.cend(); i != e; ++i) {
+                auto v = partners.get_vertex(i);
+
+                if (index_.is_B_vertex(v)) {
+                    auto b = v->get_index();
+                    auto edge = index_.find_edge(a, b);
+
+                    if (edge != index_.num_edges() and not matched_[edge] and
+                        A_residual_[a] > 0 and B_residual_[b] > 0)
+                    {
+                        matched_[edge] = true;
+                        --A_residual_[a];
+                        --B_residual_[b];
+                        ++cardinality_;
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool HopcroftKarp::build_layers() {
+    IndexListType frontier, next;
+
+    A_level_.assign(index_.num_A_vertices(), INFINITE_LEVEL);
+    B_level_.assign(index_.num_B_vertices(), INFINITE_LEVEL);
+    A_visited_.assign(index_.num_A_vertices(), false);
+    B_visited_.assign(index_.num_B_vertices(), false);
+    sink_level_ = INFINITE_LEVEL;
+
+    // the first layer are the vertices in A with residual capacity
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        if (A_residual_[a] > 0) {
+            A_level_[a] = 0;
+            A_visited_[a] = true;
+            frontier.emplace_back(a);
+        }
+    }
+
+    // grow the layers until a vertex in B with residual capacity is found
+    while (not frontier.empty() and sink_level_ == INFINITE_LEVEL) {
+        next.clear();
+
+        for (auto a : frontier) {
+            for (auto e = index_.A_begin(a), ee = index_.A_end(a); e != ee; ++e) {
+                auto b = index_.get_head(e);
+
+                // only unmatched edges go from A to B
+                if (matched_[e] or B_visited_[b]) {
+                    continue;
+                }
+
+                B_visited_[b] = true;
+                B_level_[b] = A_level_[a] + 1;
+
+                if (B_residual_[b] > 0) {
+                    // shortest augmenting paths end in this layer
+                    sink_level_ = B_level_[b] + 1;
+                } else {
+                    // only matched edges go from B to A
+                    for (auto i = index_.B_begin(b), ie = index_.B_end(b); i != ie; ++i) {
+                        auto edge = index_.B_edge(i);
+                        auto u = index_.get_tail(edge);
+
+                        if (matched_[edge] and not A_visited_[u]) {
+                            A_visited_[u] = true;
+                            A_level_[u] = B_level_[b] + 1;
+                            next.emplace_back(u);
+                        }
+                    }
+                }
+            }
+        }
+
+        frontier.swap(next);
+    }
+
+    return sink_level_ != INFINITE_LEVEL;
+}
+
+bool HopcroftKarp::augment_from(IndexType root, PathListType* paths) {
+    IndexType a = root;
+    path_.clear();
+
+    while (true) {
+        bool advanced = false;
+
+        // look for an edge to the next layer which has not been exhausted
+        for (; A_arc_[a] < index_.A_end(a); ++A_arc_[a]) {
+            auto e = A_arc_[a];
+            auto b = index_.get_head(e);
+
+            if (matched_[e] or B_level_[b] != A_level_[a] + 1) {
+                continue;
+            }
+
+            // b ends a shortest augmenting path if it has residual capacity
+            if (B_level_[b] + 1 == sink_level_) {
+                if (B_residual_[b] > 0) {
+                    path_.emplace_back(e);
+                    break;
+                }
+
+                continue;
+            }
+
+            // otherwise continue through a matched edge of b
+            for (; B_arc_[b] < index_.B_end(b); ++B_arc_[b]) {
+                auto edge = index_.B_edge(B_arc_[b]);
+
+                if (matched_[edge] and
+                    A_level_[index_.get_tail(edge)] == B_level_[b] + 1)
+                {
+                    break;
+                }
+            }
+
+            if (B_arc_[b] < index_.B_end(b)) {
+                auto edge = index_.B_edge(B_arc_[b]);
+                path_.emplace_back(e);
+                path_.emplace_back(edge);
+                a = index_.get_tail(edge);
+                advanced = true;
+                break;
+            }
+        }
+
+        if (advanced) {
+            continue;
+        }
+
+        // found an augmenting path
+        if (A_arc_[a] < index_.A_end(a)) {
+            break;
+        }
+
+        // a is a dead end for this phase
+        A_level_[a] = INFINITE_LEVEL;
+
+        if (path_.empty()) {
+            return false;
+        }
+
+        // retreat to the previous vertex in A, and skip the matched edge
+        // which led to a
+        path_.pop_back();
+        auto e = path_.back();
+        path_.pop_back();
+        a = index_.get_tail(e);
+        ++B_arc_[index_.get_head(e)];
+    }
+
+    // flip the edges on the path
+    PathType path;
+    for (SizeType i = 0; i < path_.size(); ++i) {
+        auto e = path_[i];
+        matched_[e] = not matched_[e];
+
+        if (paths and i % 2 == 0) {
+            path.emplace_back(index_.get_graph().get_A_vertices()[index_.get_tail(e)]);
+            path.emplace_back(index_.get_graph().get_B_vertices()[index_.get_head(e)]);
+        }
+    }
+
+    --A_residual_[root];
+    --B_residual_[index_.get_head(path_.back())];
+    ++cardinality_;
+
+    if (paths) {
+        paths->emplace_back(path);
+    }
+
+    return true;
+}
+
+HopcroftKarp::SizeType HopcroftKarp::augment_phase(PathListType* paths) {
+    SizeType naugmented = 0;
+
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        A_arc_[a] = index_.A_begin(a);
+    }
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        B_arc_[b] = index_.B_begin(b);
+    }
+
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        while (A_level_[a] == 0 and A_residual_[a] > 0 and augment_from(a, paths)) {
+            ++naugmented;
+        }
+    }
+
+    return naugmented;
+}
+
+HopcroftKarp::SizeType HopcroftKarp::compute_maximum() {
+    while (build_layers()) {
+        augment_phase(nullptr);
+    }
+
+    return cardinality_;
+}
+
+HopcroftKarp::SizeType HopcroftKarp::get_cardinality() const {
+    return cardinality_;
+}
+
+bool HopcroftKarp::is_matched(IndexType e) const {
+    return matched_[e];
+}
+
+HopcroftKarp::Result HopcroftKarp::check(const MatchedPairListType& M, bool find_paths) {
+    Result result;
+
+    set_matching(M);
+    result.cardinality = cardinality_;
+    result.is_maximum = not build_layers();
+
+    // the paths found in the first phase are disjoint shortest augmenting
+    // paths with respect to M
+    if (find_paths and not result.is_maximum) {
+        augment_phase(&result.paths);
+    }
+
+    result.max_cardinality = compute_maximum();
+    return result;
+}
+
+bool HopcroftKarp::has_augmenting_path(const MatchedPairListType& M) {
+    set_matching(M);
+    return build_layers();
+}
+
+void HopcroftKarp::get_matched_pairs(MatchedPairListType& M) const {
+    const auto& A = index_.get_graph().get_A_vertices();
+    const auto& B = index_.get_graph().get_B_vertices();
+
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        if (matched_[e]) {
+            auto a = A[index_.get_tail(e)];
+            auto b = B[index_.get_head(e)];
+            auto b_rank = index_.get_B_rank(e);
+
+            M[a].add_partner(std::make_pair(index_.get_A_rank(e), b));
+            M[b].add_partner(std::make_pair(
+                b_rank == GraphIndex::UNRANKED ? 1 : b_rank, a));
+        }
+    }
+}
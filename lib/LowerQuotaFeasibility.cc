@@ -0,0 +1,78 @@
+#include "LowerQuotaFeasibility.h"
+#include "FlowNetwork.h"
+#include "GraphIndex.h"
+#include "Vertex.h"
+
+LowerQuotaFeasibility::LowerQuotaFeasibility(const BipartiteGraph& G)
+    : deficiency_(0)
+{
+    GraphIndex index(G);
+    const auto& A = G.get_A_vertices();
+    const auto& B = G.get_B_vertices();
+    auto nA = index.num_A_vertices();
+    auto nB = index.num_B_vertices();
+
+    // nodes 0 to 3 are the source, the sink and the super source and sink
+    // of the circulation, followed by the vertices in A and then those in B
+    std::vector<NodePtr> nodes;
+    nodes.emplace_back(new Node("source", 0, Node::ROLE_SOURCE));
+    nodes.emplace_back(new Node("sink", 1, Node::ROLE_SINK));
+    nodes.emplace_back(new Node("super_source", 2));
+    nodes.emplace_back(new Node("super_sink", 3));
+
+    for (IndexType a = 0; a < nA; ++a) {
+        nodes.emplace_back(new Node(A[a]->get_id(), nodes.size()));
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        nodes.emplace_back(new Node(B[b]->get_id(), nodes.size()));
+    }
+
+    FlowNetwork H(nodes.size());
+    FlowType total_quota = 0;
+
+    for (IndexType a = 0; a < nA; ++a) {
+        H.add_edge(nodes[0], nodes[4 + a], A[a]->get_lower_quota(), index.get_A_quota(a), 0);
+        total_quota += index.get_A_quota(a);
+    }
+
+    for (IndexType e = 0; e < index.num_edges(); ++e) {
+        H.add_edge(nodes[4 + index.get_tail(e)], nodes[4 + nA + index.get_head(e)], 1, 0);
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        H.add_edge(nodes[4 + nA + b], nodes[1], B[b]->get_lower_quota(), index.get_B_quota(b), 0);
+    }
+
+    // no flow larger than the quotas of A comes back to the source
+    H.add_edge(nodes[1], nodes[0], total_quota, 0);
+
+    deficiency_ = H.compute_feasible_circulation(nodes[2], nodes[3]);
+    if (deficiency_ == 0) {
+        return;
+    }
+
+    // the vertices of B which can still send flow to the super sink did
+    // not get the flow of their lower quotas
+    H.decompose_nodes_STU(nodes[2], nodes[3]);
+    for (IndexType b = 0; b < nB; ++b) {
+        if (nodes[4 + nA + b]->get_decomposition_label() == Node::LABEL_T) {
+            deficient_set_.emplace_back(B[b]);
+        }
+    }
+}
+
+LowerQuotaFeasibility::~LowerQuotaFeasibility()
+{}
+
+bool LowerQuotaFeasibility::is_feasible() const {
+    return deficiency_ == 0;
+}
+
+FlowType LowerQuotaFeasibility::get_deficiency() const {
+    return deficiency_;
+}
+
+const std::vector<VertexPtr>& LowerQuotaFeasibility::get_deficient_set() const {
+    return deficient_set_;
+}
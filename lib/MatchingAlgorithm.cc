@@ -18,6 +18,13 @@ const std::unique_ptr<BipartiteGraph>& MatchingAlgorithm::get_graph() const {
     return G_;
 }
 
+bool MatchingAlgorithm::get_witness(PopularityWitness& witness) {
+    return false;
+}
+
+void MatchingAlgorithm::write_statistics(std::ostream& out) const
+{}
+
 bool MatchingAlgorithm::is_feasible(const std::unique_ptr<BipartiteGraph>& G,
                                     const MatchedPairListType& M) {
   auto feasible_for_vertices = [&M] (const BipartiteGraph::ContainerType& vertices) {
@@ -53,30 +60,44 @@ MatchedPairListType& MatchingAlgorithm::map_inverse(const MatchedPairListType& M
     auto& A = G->get_A_partition();
     auto& B = G->get_B_partition();
 
-    for (auto it : M) {
-        auto a = it.first;
+    // the vertices of G and the rank of orig_b on the list of orig_a, looked
+    // up by the ids in case the reduction did not record the origins
+    auto find_by_id = [&A, &B] (const VertexPtr& a, const VertexPtr& b,
+                                VertexPtr& orig_a, VertexPtr& orig_b) {
+        const auto& ac_id = a->get_cloned_for_id(); // vertex from which a was cloned
+        const auto& bc_id = b->get_cloned_for_id();
+
+        // is A the partition to which a belongs in the original graph G
+        bool is_a_partition_A = A.find(ac_id) != A.end();
+        orig_a = is_a_partition_A ? A.at(ac_id) : B.at(ac_id);
+        orig_b = is_a_partition_A ? B.at(bc_id) : A.at(bc_id);
+
+        // get the rank of b in a's preference list
+        auto orig_a_pl = orig_a->get_preference_list();
+        return orig_a_pl.get_rank(orig_a_pl.find(orig_b));
+    };
+
+    for (const auto& it : M) {
+        const auto& a = it.first;
 
         // if a is not a dummy vertex
         if (not a->is_dummy()) {
-            auto& partners = it.second;
-            const auto& ac_id = a->get_cloned_for_id(); // vertex from which a was cloned
-            // is A the partition to which a belongs in the original graph G
-            bool is_a_partition_A = (A.find(ac_id) != A.end()) ? true : false;
+            const auto& partners = it.second;
 
-            for (auto i = partners.begin(), e = partners.end(); i != e; ++i) {
+            for (auto i = partners.cbegin(), e = partners.cend(); i != e; ++i) {
                 auto b = partners.get_vertex(i);
 
                 // do not add a dummy partner to the matching
                 if (not b->is_dummy()) {
-                    const auto& bc_id = b->get_cloned_for_id();
-
-                    // get the vertex from the original graph G
-                    auto orig_a = is_a_partition_A ? A.at(ac_id) : B.at(ac_id);
-                    auto orig_b = is_a_partition_A ? B.at(bc_id) : A.at(bc_id);
-
-                    // get the rank of b in a's preference list
-                    auto orig_a_pl = orig_a->get_preference_list();
-                    auto b_rank = orig_a_pl.get_rank(orig_a_pl.find(orig_b));
+                    // the vertices from the original graph G and the rank of
+                    // b in a's preference list, recorded by the reduction
+                    VertexPtr orig_a = a->get_origin();
+                    VertexPtr orig_b = b->get_origin();
+                    RankType b_rank = a->get_origin_rank(partners.get_rank(i));
+
+                    if (not orig_a or not orig_b or b_rank == 0) {
+                        b_rank = find_by_id(a, b, orig_a, orig_b);
+                    }
 
                     // add to the matching
                     M_[orig_a].add_partner(std::make_pair(b_rank, orig_b));
@@ -0,0 +1,607 @@
+#include "MatchingComparison.h"
+#include "Parallel.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+// a missing partner is worse than any partner, and a partner missing from
+// a list is worse than any partner on the list
+static const RankType RANK_BOTTOM = std::numeric_limits<RankType>::max();
+static const RankType RANK_UNLISTED = RANK_BOTTOM - 1;
+
+MatchingComparison::MatchingComparison(const BipartiteGraph& G, bool one_sided)
+    : index_(G)
+{
+    for (const auto& b : G.get_B_vertices()) {
+        auto& pref_list = b->get_preference_list();
+        B_votes_.emplace_back(not one_sided and pref_list.all_begin() != pref_list.all_end());
+    }
+}
+
+MatchingComparison::~MatchingComparison()
+{}
+
+const GraphIndex& MatchingComparison::get_index() const {
+    return index_;
+}
+
+RankType MatchingComparison::get_A_rank(IndexType e) const {
+    return index_.get_A_rank(e);
+}
+
+RankType MatchingComparison::get_B_rank(IndexType e) const {
+    auto rank = index_.get_B_rank(e);
+    return rank == GraphIndex::UNRANKED ? RANK_UNLISTED : rank;
+}
+
+MatchingComparison::EdgeSetType
+MatchingComparison::get_edge_set(const MatchedPairListType& M) const {
+    EdgeSetType edges(index_.num_edges(), 0);
+
+    // edge_of[b] is the edge (a, b) while the partners of a are looked at
+    IndexListType edge_of(index_.num_B_vertices(), index_.num_edges());
+
+    for (const auto& it : M) {
+        const auto& u = it.first;
+
+        if (not index_.is_A_vertex(u)) {
+            continue;
+        }
+
+        auto a = u->get_index();
+        const auto& partners = it.second;
+
+        for (auto e = index_.A_begin(a), ee = index_.A_end(a); e != ee; ++e) {
+            edge_of[index_.get_head(e)] = e;
+        }
+
+        for (auto i = partners.cbegin(), e = partners.cend(); i != e; ++i) {
+            auto v = partners.get_vertex(i);
+
+            if (not index_.is_B_vertex(v) or edge_of[v->get_index()] == index_.num_edges()) {
+                throw std::runtime_error("matched pair " + u->get_id() + ","
+                                         + v->get_id() + " is not an edge");
+            }
+
+            edges[edge_of[v->get_index()]] = 1;
+        }
+
+        for (auto e = index_.A_begin(a), ee = index_.A_end(a); e != ee; ++e) {
+            edge_of[index_.get_head(e)] = index_.num_edges();
+        }
+    }
+
+    return edges;
+}
+
+void MatchingComparison::vote(std::vector<RankType>& first,
+                              std::vector<RankType>& second,
+                              VoteCount& count) const
+{
+    std::sort(first.begin(), first.end());
+    std::sort(second.begin(), second.end());
+
+    for (std::vector<RankType>::size_type i = 0;
+         i < std::max(first.size(), second.size()); ++i)
+    {
+        auto r1 = i < first.size() ? first[i] : RANK_BOTTOM;
+        auto r2 = i < second.size() ? second[i] : RANK_BOTTOM;
+
+        if (r1 < r2) {
+            ++count.first;
+        } else if (r2 < r1) {
+            ++count.second;
+        }
+    }
+}
+
+MatchingComparison::VoteCount
+MatchingComparison::compare(const EdgeSetType& M1, const EdgeSetType& M2) const {
+    auto nA = index_.num_A_vertices();
+    auto nB = index_.num_B_vertices();
+    std::vector<VoteCount> A_counts(parallel_blocks(nA), VoteCount{0, 0});
+    std::vector<VoteCount> B_counts(parallel_blocks(nB), VoteCount{0, 0});
+
+    // partners common to both matchings are not looked at
+    parallel_for(nA, [&] (unsigned block, IndexType begin, IndexType end) {
+        std::vector<RankType> first, second;
+
+        for (auto a = begin; a < end; ++a) {
+            first.clear();
+            second.clear();
+
+            for (auto e = index_.A_begin(a), ee = index_.A_end(a); e != ee; ++e) {
+                if (M1[e] and not M2[e]) {
+                    first.emplace_back(get_A_rank(e));
+                } else if (M2[e] and not M1[e]) {
+                    second.emplace_back(get_A_rank(e));
+                }
+            }
+
+            vote(first, second, A_counts[block]);
+        }
+    });
+
+    parallel_for(nB, [&] (unsigned block, IndexType begin, IndexType end) {
+        std::vector<RankType> first, second;
+
+        for (auto b = begin; b < end; ++b) {
+            if (not B_votes_[b]) {
+                continue;
+            }
+
+            first.clear();
+            second.clear();
+
+            for (auto i = index_.B_begin(b), ie = index_.B_end(b); i != ie; ++i) {
+                auto e = index_.B_edge(i);
+
+                if (M1[e] and not M2[e]) {
+                    first.emplace_back(get_B_rank(e));
+                } else if (M2[e] and not M1[e]) {
+                    second.emplace_back(get_B_rank(e));
+                }
+            }
+
+            vote(first, second, B_counts[block]);
+        }
+    });
+
+    VoteCount count{0, 0};
+    for (const auto& c : A_counts) {
+        count.first += c.first;
+        count.second += c.second;
+    }
+
+    for (const auto& c : B_counts) {
+        count.first += c.first;
+        count.second += c.second;
+    }
+
+    return count;
+}
+
+MatchingComparison::VoteCount
+MatchingComparison::compare(const MatchedPairListType& M1,
+                            const MatchedPairListType& M2) const
+{
+    return compare(get_edge_set(M1), get_edge_set(M2));
+}
+
+long MatchingComparison::max_weight_matching(const std::vector<long>& weights,
+                                             EdgeSetType& M) const
+{
+    typedef std::pair<long, IndexType> HeapEntry;
+    static const long INFINITE_DIST = std::numeric_limits<long>::max();
+
+    auto nA = index_.num_A_vertices();
+    auto nB = index_.num_B_vertices();
+    IndexType source = nA + nB, sink = nA + nB + 1, nnodes = nA + nB + 2;
+
+    // residual network source -> A -> B -> sink, where arc i ^ 1 is the
+    // reverse of arc i, only edges of positive weight can be in the matching
+    IndexListType tails, heads, caps, edge_of_arc;
+    std::vector<long> costs;
+
+    auto add_arc = [&] (IndexType u, IndexType v, IndexType cap, long cost, IndexType e) {
+        tails.emplace_back(u); heads.emplace_back(v);
+        caps.emplace_back(cap); costs.emplace_back(cost);
+        edge_of_arc.emplace_back(e);
+        tails.emplace_back(v); heads.emplace_back(u);
+        caps.emplace_back(0); costs.emplace_back(-cost);
+        edge_of_arc.emplace_back(e);
+    };
+
+    for (IndexType a = 0; a < nA; ++a) {
+        add_arc(source, a, index_.get_A_quota(a), 0, index_.num_edges());
+    }
+
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        if (weights[e] > 0) {
+            add_arc(index_.get_tail(e), nA + index_.get_head(e), 1, -weights[e], e);
+        }
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        add_arc(nA + b, sink, index_.get_B_quota(b), 0, index_.num_edges());
+    }
+
+    // arcs leaving a node u are arcs_[offsets[u] .. offsets[u+1])
+    IndexListType offsets(nnodes + 1, 0), arcs(tails.size());
+    for (auto u : tails) {
+        ++offsets[u+1];
+    }
+
+    for (IndexType u = 0; u < nnodes; ++u) {
+        offsets[u+1] += offsets[u];
+    }
+
+    IndexListType next(offsets.begin(), offsets.end() - 1);
+    for (IndexType i = 0; i < tails.size(); ++i) {
+        arcs[next[tails[i]]++] = i;
+    }
+
+    // feasible potentials for the initial network, which is acyclic
+    std::vector<long> potential(nnodes, 0);
+    for (IndexType i = 0; i < tails.size(); i += 2) {
+        if (heads[i] >= nA and heads[i] < nA + nB) {
+            potential[heads[i]] = std::min(potential[heads[i]], costs[i]);
+        }
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        potential[sink] = std::min(potential[sink], potential[nA + b]);
+    }
+
+    std::vector<long> dist(nnodes);
+    IndexListType parent(nnodes);
+    long total_weight = 0;
+
+    while (true) {
+        // Dijkstra on the reduced costs, which are non-negative
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > heap;
+        dist.assign(nnodes, INFINITE_DIST);
+        dist[source] = 0;
+        heap.emplace(0, source);
+
+        while (not heap.empty()) {
+            auto top = heap.top();
+            heap.pop();
+            auto u = top.second;
+
+            if (top.first > dist[u]) {
+                continue;
+            }
+
+            for (auto j = offsets[u]; j < offsets[u+1]; ++j) {
+                auto i = arcs[j];
+                auto v = heads[i];
+                long d = dist[u] + costs[i] + potential[u] - potential[v];
+
+                if (caps[i] > 0 and d < dist[v]) {
+                    dist[v] = d;
+                    parent[v] = i;
+                    heap.emplace(d, v);
+                }
+            }
+        }
+
+        // stop when the shortest path does not increase the weight
+        if (dist[sink] == INFINITE_DIST or
+            dist[sink] + potential[sink] - potential[source] >= 0)
+        {
+            break;
+        }
+
+        for (IndexType u = 0; u < nnodes; ++u) {
+            potential[u] += std::min(dist[u], dist[sink]);
+        }
+
+        IndexType flow = std::numeric_limits<IndexType>::max();
+        for (auto v = sink; v != source; v = tails[parent[v]]) {
+            flow = std::min(flow, caps[parent[v]]);
+        }
+
+        for (auto v = sink; v != source; v = tails[parent[v]]) {
+            caps[parent[v]] -= flow;
+            caps[parent[v] ^ 1] += flow;
+            total_weight -= flow * costs[parent[v]];
+        }
+    }
+
+    // an edge is in the matching if its arc is saturated
+    M.assign(index_.num_edges(), 0);
+    for (IndexType i = 0; i < tails.size(); i += 2) {
+        if (edge_of_arc[i] != index_.num_edges() and caps[i] == 0) {
+            M[edge_of_arc[i]] = 1;
+        }
+    }
+
+    return total_weight;
+}
+
+MatchingComparison::VoteCount
+MatchingComparison::max_ratio_matching(const EdgeSetType& M, unsigned long p,
+                                       unsigned long q, EdgeSetType& M_other) const
+{
+    auto nA = index_.num_A_vertices();
+    auto nB = index_.num_B_vertices();
+
+    // rank of the partner in M, if any
+    std::vector<RankType> A_partner(nA, RANK_BOTTOM), B_partner(nB, RANK_BOTTOM);
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        if (M[e]) {
+            A_partner[index_.get_tail(e)] = get_A_rank(e);
+            B_partner[index_.get_head(e)] = get_B_rank(e);
+        }
+    }
+
+    // a voter gains q if it prefers its edge to its partner in M, and loses
+    // p if it is worse off, a voter matched in M loses p when left unmatched
+    // which is accounted for by adding p to each of its edges
+    auto gain = [p, q] (RankType rank, RankType partner, bool in_M) -> long {
+        long w = partner == RANK_BOTTOM ? 0 : (long) p;
+
+        if (in_M) {
+            return w;
+        } else if (rank < partner) {
+            return w + (long) q;
+        } else if (partner < rank) {
+            return w - (long) p;
+        }
+
+        return w;
+    };
+
+    std::vector<long> weights(index_.num_edges());
+    parallel_for(nA, [&] (unsigned, IndexType begin, IndexType end) {
+        for (auto a = begin; a < end; ++a) {
+            for (auto e = index_.A_begin(a), ee = index_.A_end(a); e != ee; ++e) {
+                auto b = index_.get_head(e);
+                weights[e] = gain(get_A_rank(e), A_partner[a], M[e]);
+
+                if (B_votes_[b]) {
+                    weights[e] += gain(get_B_rank(e), B_partner[b], M[e]);
+                }
+            }
+        }
+    });
+
+    max_weight_matching(weights, M_other);
+    return compare(M_other, M);
+}
+
+MatchingComparison::Factor
+MatchingComparison::unpopularity_factor(const MatchedPairListType& M) const {
+    unsigned long nvoters = 0;
+
+    for (IndexType a = 0; a < index_.num_A_vertices(); ++a) {
+        if (index_.A_begin(a) != index_.A_end(a) and index_.get_A_quota(a) > 1) {
+            throw std::runtime_error("unpopularity factor requires unit quotas");
+        }
+
+        ++nvoters;
+    }
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        if (B_votes_[b] and index_.get_B_quota(b) > 1) {
+            throw std::runtime_error("unpopularity factor requires unit quotas");
+        }
+
+        nvoters += B_votes_[b];
+    }
+
+    auto in_M = get_edge_set(M);
+    EdgeSetType M_other;
+
+    // the factor is unbounded if some matching is preferred by a vertex
+    // and is not worse for any vertex, a single vote against a matching
+    // outweighs every vote for it when p = nvoters + 1
+    auto count = max_ratio_matching(in_M, nvoters + 1, 1, M_other);
+    if (count.first > (nvoters + 1) * count.second) {
+        return Factor{1, 0};
+    }
+
+    // Dinkelbach's method, p/q increases strictly until it is the maximum
+    unsigned long p = 0, q = 1;
+    while (true) {
+        count = max_ratio_matching(in_M, p, q, M_other);
+
+        if (q * count.first <= p * count.second) {
+            break;
+        }
+
+        p = count.first;
+        q = count.second;
+    }
+
+    // reduce the fraction
+    unsigned long x = p, y = q;
+    while (y != 0) {
+        auto r = x % y;
+        x = y;
+        y = r;
+    }
+
+    return Factor{p / x, q / x};
+}
+
+namespace {
+
+// the seats of every vertex in one partition sorted by the rank of the
+// partner they hold, free seats are represented by a single seat at the end
+struct SeatIndex {
+    static const long INFINITE_SLACK = std::numeric_limits<long>::max() / 2;
+
+    GraphIndex::IndexListType offsets;
+    std::vector<RankType> ranks;
+    std::vector<long> alphas;
+    std::vector<long> prefix_min;   // min alpha over the seats up to this one
+    std::vector<long> suffix_min;   // min alpha over the seats from this one
+
+    // min over the seats of v of (alpha - vote of the seat for a partner of
+    // the given rank), the vote is +1 if the partner is better than the one
+    // in the seat, -1 if it is worse and 0 otherwise
+    long min_slack(IndexType v, RankType rank, bool votes) const {
+        auto begin = offsets[v], end = offsets[v+1];
+
+        if (begin == end) {
+            return INFINITE_SLACK;
+        } else if (not votes) {
+            return suffix_min[begin];
+        }
+
+        auto lo = std::lower_bound(ranks.begin() + begin, ranks.begin() + end, rank)
+                  - ranks.begin();
+        auto hi = std::upper_bound(ranks.begin() + lo, ranks.begin() + end, rank)
+                  - ranks.begin();
+        long slack = INFINITE_SLACK;
+
+        if ((IndexType) lo > begin) {
+            slack = std::min(slack, prefix_min[lo-1] + 1);
+        }
+
+        for (auto j = lo; j < hi; ++j) {
+            slack = std::min(slack, alphas[j]);
+        }
+
+        if ((IndexType) hi < end) {
+            slack = std::min(slack, suffix_min[hi] - 1);
+        }
+
+        return slack;
+    }
+};
+
+}
+
+bool MatchingComparison::verify_witness(const MatchedPairListType& M,
+                                        const PopularityWitness& witness,
+                                        std::string& error) const
+{
+    const auto& A = index_.get_graph().get_A_vertices();
+    const auto& B = index_.get_graph().get_B_vertices();
+    auto nA = index_.num_A_vertices();
+    auto nB = index_.num_B_vertices();
+    auto in_M = get_edge_set(M);
+    long alpha_sum = 0;
+
+    // build the seats of the vertices of a partition and check the seat
+    // constraints, edges(v, f) calls f(e) for every edge e incident to v
+    auto build_seats = [&] (SeatIndex& seats, IndexType n,
+                            const BipartiteGraph::IndexedContainerType& vertices,
+                            const BipartiteGraph::IndexedContainerType& others,
+                            bool partition_A) -> bool
+    {
+        std::vector<std::pair<RankType, long> > vertex_seats;
+        seats.offsets.assign(1, 0);
+
+        for (IndexType v = 0; v < n; ++v) {
+            const auto& u = vertices[v];
+            bool votes = partition_A or B_votes_[v];
+            unsigned quota = partition_A ? index_.get_A_quota(v) : index_.get_B_quota(v);
+            vertex_seats.clear();
+
+            auto add_seat = [&] (IndexType e) {
+                if (in_M[e]) {
+                    const auto& partner = partition_A ? others[index_.get_head(e)]
+                                                      : others[index_.get_tail(e)];
+                    auto rank = partition_A ? get_A_rank(e) : get_B_rank(e);
+                    vertex_seats.emplace_back(rank, witness.get_alpha(u, partner));
+                }
+            };
+
+            if (partition_A) {
+                for (auto e = index_.A_begin(v), ee = index_.A_end(v); e != ee; ++e) {
+                    add_seat(e);
+                }
+            } else {
+                for (auto i = index_.B_begin(v), ie = index_.B_end(v); i != ie; ++i) {
+                    add_seat(index_.B_edge(i));
+                }
+            }
+
+            if (vertex_seats.size() > quota) {
+                error = "vertex " + u->get_id() + " has more partners than its quota";
+                return false;
+            }
+
+            // an occupied seat can lose the vote of its vertex, a free seat cannot
+            for (const auto& seat : vertex_seats) {
+                if (seat.second < (votes ? -1 : 0)) {
+                    error = "seat constraint violated for vertex " + u->get_id();
+                    return false;
+                }
+
+                alpha_sum += seat.second;
+            }
+
+            if (vertex_seats.size() < quota) {
+                long free_alpha = witness.get_free_alpha(u);
+
+                if (free_alpha < 0) {
+                    error = "seat constraint violated for vertex " + u->get_id();
+                    return false;
+                }
+
+                alpha_sum += free_alpha * (quota - vertex_seats.size());
+                vertex_seats.emplace_back(RANK_BOTTOM, free_alpha);
+            }
+
+            std::sort(vertex_seats.begin(), vertex_seats.end());
+            for (const auto& seat : vertex_seats) {
+                seats.ranks.emplace_back(seat.first);
+                seats.alphas.emplace_back(seat.second);
+            }
+
+            seats.offsets.emplace_back(seats.ranks.size());
+        }
+
+        seats.prefix_min = seats.alphas;
+        seats.suffix_min = seats.alphas;
+
+        for (IndexType v = 0; v < n; ++v) {
+            for (auto j = seats.offsets[v] + 1; j < seats.offsets[v+1]; ++j) {
+                seats.prefix_min[j] = std::min(seats.prefix_min[j], seats.prefix_min[j-1]);
+            }
+
+            for (auto j = seats.offsets[v+1]; j > seats.offsets[v] + 1; --j) {
+                seats.suffix_min[j-2] = std::min(seats.suffix_min[j-2], seats.suffix_min[j-1]);
+            }
+        }
+
+        return true;
+    };
+
+    SeatIndex A_seats, B_seats;
+    if (not build_seats(A_seats, nA, A, B, true) or
+        not build_seats(B_seats, nB, B, A, false))
+    {
+        return false;
+    }
+
+    if (alpha_sum > 0) {
+        error = "the sum of the alphas is positive";
+        return false;
+    }
+
+    // the first violated edge found by every block
+    auto nedges = index_.num_edges();
+    IndexListType violated(parallel_blocks(nedges), nedges);
+
+    parallel_for(nedges, [&] (unsigned block, IndexType begin, IndexType end) {
+        for (auto e = begin; e < end; ++e) {
+            auto a = index_.get_tail(e);
+            auto b = index_.get_head(e);
+            bool ok = true;
+
+            if (in_M[e]) {
+                ok = witness.get_alpha(A[a], B[b]) + witness.get_alpha(B[b], A[a]) >= 0;
+            } else {
+                auto a_slack = A_seats.min_slack(a, get_A_rank(e), true);
+                auto b_slack = B_seats.min_slack(b, get_B_rank(e), B_votes_[b]);
+
+                ok = a_slack == SeatIndex::INFINITE_SLACK or
+                     b_slack == SeatIndex::INFINITE_SLACK or a_slack + b_slack >= 0;
+            }
+
+            if (not ok) {
+                violated[block] = e;
+                break;
+            }
+        }
+    });
+
+    auto e = *std::min_element(violated.begin(), violated.end());
+    if (e != nedges) {
+        error = "edge constraint violated for " + A[index_.get_tail(e)]->get_id()
+                + "," + B[index_.get_head(e)]->get_id();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#include "MaxCardinality.h"
+#include "HopcroftKarp.h"
+#include "AssignmentNetwork.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+
+MaxCardinality::MaxCardinality(const std::unique_ptr<BipartiteGraph>& G,
+                               bool A_proposing)
+    : MatchingAlgorithm(G)
+{}
+
+MaxCardinality::~MaxCardinality()
+{}
+
+bool MaxCardinality::compute_matching() {
+    GraphIndex index(*get_graph());
+    bool unit_quotas = true;
+
+    for (IndexType a = 0; a < index.num_A_vertices(); ++a) {
+        unit_quotas = unit_quotas and index.get_A_quota(a) <= 1;
+    }
+
+    for (IndexType b = 0; b < index.num_B_vertices(); ++b) {
+        unit_quotas = unit_quotas and index.get_B_quota(b) <= 1;
+    }
+
+    M_.clear();
+    if (unit_quotas) {
+        compute_unit_matching(index);
+    } else {
+        compute_flow_matching(index);
+    }
+
+    // a maximum matching always exists
+    return true;
+}
+
+void MaxCardinality::compute_unit_matching(const GraphIndex& index) {
+    HopcroftKarp hk(index.get_graph());
+    hk.compute_maximum();
+    hk.get_matched_pairs(M_);
+}
+
+void MaxCardinality::compute_flow_matching(const GraphIndex& index) {
+    AssignmentNetwork H(index);
+    H.compute_max_flow();
+    H.get_matched_pairs(M_);
+}
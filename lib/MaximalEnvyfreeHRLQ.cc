@@ -56,6 +56,7 @@ std::unique_ptr<BipartiteGraph> MaximalEnvyfreeHRLQ::augment_graph(MatchedPairLi
         auto u_id = v->get_id();
         auto nmatched = M.find(v) == M.end() ? 0 : M.find(v)->second.size();
         auto u = std::make_shared<Vertex>(u_id, 0, v->get_upper_quota() - nmatched);
+        u->set_origin(v, 0);
 
         auto& v_pref_list = v->get_preference_list();
         auto& u_pref_list = u->get_preference_list();
@@ -77,11 +78,12 @@ std::unique_ptr<BipartiteGraph> MaximalEnvyfreeHRLQ::augment_graph(MatchedPairLi
                 if (A.find(r_id) == A.end()) {
                     auto r = std::make_shared<Vertex>(r_id,
                                 r_old->get_lower_quota(), r_old->get_upper_quota());
+                    r->set_origin(r_old, 0);
                     A.emplace(r_id, r);
                 }
 
                 // add r to u's pref list
-                u_pref_list.emplace_back(A.find(r_id)->second);
+                u->emplace_back_with_origin(A.find(r_id)->second, v_pref_list.get_rank(*i));
             } else {
                 auto Mr = rit->second.get_vertex(rit->second.get_least_preferred());
 
@@ -114,7 +116,6 @@ std::unique_ptr<BipartiteGraph> MaximalEnvyfreeHRLQ::augment_graph(MatchedPairLi
     for (auto it : A) {
         auto r = it.second;
         auto r_old = A_old.at(r->get_id());
-        auto& r_pref_list = r->get_preference_list();
         auto& old_pref_list = r_old->get_preference_list();
 
         for (auto i = old_pref_list.all_begin(), e = old_pref_list.all_end();
@@ -127,7 +128,8 @@ std::unique_ptr<BipartiteGraph> MaximalEnvyfreeHRLQ::augment_graph(MatchedPairLi
                 auto h_pref_list = B.find(h_old->get_id())->second->get_preference_list();
                 
                 if (h_pref_list.find(r) != h_pref_list.end()) {
-                    r_pref_list.emplace_back(B.at(h_old->get_id()));
+                    r->emplace_back_with_origin(B.at(h_old->get_id()),
+                                                old_pref_list.get_rank(*i));
                 }
             }
         }
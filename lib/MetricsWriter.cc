@@ -0,0 +1,144 @@
+#include "MetricsWriter.h"
+#include <fstream>
+
+namespace {
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() and
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// a CSV field, quoted if it contains a separator or a quote
+std::string csv_field(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) {
+        return s;
+    }
+
+    std::string quoted = "\"";
+    for (auto ch : s) {
+        if (ch == '"') {
+            quoted.push_back('"');
+        }
+        quoted.push_back(ch);
+    }
+
+    return quoted + '"';
+}
+
+// a JSON string
+std::string json_string(const std::string& s) {
+    std::string quoted = "\"";
+    for (auto ch : s) {
+        if (ch == '"' or ch == '\\') {
+            quoted.push_back('\\');
+            quoted.push_back(ch);
+        } else if ((unsigned char) ch < 0x20) {
+            static const char* hex = "0123456789abcdef";
+            quoted += "\\u00";
+            quoted.push_back(hex[(ch >> 4) & 0xf]);
+            quoted.push_back(hex[ch & 0xf]);
+        } else {
+            quoted.push_back(ch);
+        }
+    }
+
+    return quoted + '"';
+}
+
+}
+
+MetricsWriter::MetricsWriter(const std::string& path)
+    : MetricsWriter(path, (ends_with(path, ".json") or ends_with(path, ".jsonl")) ? JSON : CSV)
+{}
+
+MetricsWriter::MetricsWriter(const std::string& path, Format format)
+    : path_(path), format_(format)
+{}
+
+MetricsWriter::~MetricsWriter() {
+    flush();
+}
+
+void MetricsWriter::set_instance(const std::string& instance) {
+    instance_ = instance;
+}
+
+void MetricsWriter::write(const Statistics::Metrics& metrics) {
+    if (format_ == JSON) {
+        write_json(metrics);
+    } else {
+        write_csv(metrics);
+    }
+}
+
+void MetricsWriter::write_csv(const Statistics::Metrics& metrics) {
+    auto write_list = [this] (const Statistics::HospitalCountListType& list) {
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            rows_ << (it == list.begin() ? "" : " ") << it->first << ':' << it->second;
+        }
+    };
+
+    rows_ << csv_field(instance_) << ',' << metrics.S << ',' << metrics.BPC << ','
+          << metrics.BR << ',' << metrics.R1 << ',' << metrics.def << ','
+          << metrics.sum_of_lower_quota << ',';
+
+    for (std::size_t i = 0; i < metrics.rank_profile.size(); ++i) {
+        rows_ << (i == 0 ? "" : " ") << metrics.rank_profile[i];
+    }
+
+    rows_ << ',';
+    write_list(metrics.hospital_sizes);
+    rows_ << ',';
+    write_list(metrics.lower_quota_deficits);
+    rows_ << '\n';
+}
+
+void MetricsWriter::write_json(const Statistics::Metrics& metrics) {
+    auto write_list = [this] (const Statistics::HospitalCountListType& list) {
+        rows_ << '{';
+        for (auto it = list.begin(); it != list.end(); ++it) {
+            rows_ << (it == list.begin() ? "" : ",") << json_string(it->first) << ':' << it->second;
+        }
+        rows_ << '}';
+    };
+
+    rows_ << "{\"instance\":" << json_string(instance_)
+          << ",\"size\":" << metrics.S
+          << ",\"blocking_pairs\":" << metrics.BPC
+          << ",\"blocking_residents\":" << metrics.BR
+          << ",\"rank1\":" << metrics.R1
+          << ",\"deficiency\":" << metrics.def
+          << ",\"sum_of_lower_quota\":" << metrics.sum_of_lower_quota
+          << ",\"rank_profile\":[";
+
+    for (std::size_t i = 0; i < metrics.rank_profile.size(); ++i) {
+        rows_ << (i == 0 ? "" : ",") << metrics.rank_profile[i];
+    }
+
+    rows_ << "],\"hospital_sizes\":";
+    write_list(metrics.hospital_sizes);
+    rows_ << ",\"lower_quota_deficits\":";
+    write_list(metrics.lower_quota_deficits);
+    rows_ << "}\n";
+}
+
+void MetricsWriter::flush() {
+    std::string rows = rows_.str();
+    if (rows.empty()) {
+        return;
+    }
+
+    // a new CSV file starts with the names of the columns
+    std::ifstream in(path_, std::ios::ate | std::ios::binary);
+    bool empty = not in or in.tellg() == 0;
+    in.close();
+
+    std::ofstream out(path_, std::ios::app);
+    if (format_ == CSV and empty) {
+        out << "instance,size,blocking_pairs,blocking_residents,rank1,deficiency,"
+            << "sum_of_lower_quota,rank_profile,hospital_sizes,lower_quota_deficits\n";
+    }
+
+    out << rows;
+    rows_.str("");
+}
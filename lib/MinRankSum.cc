@@ -0,0 +1,32 @@
+#include "MinRankSum.h"
+#include "GraphIndex.h"
+#include "AssignmentNetwork.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+
+MinRankSum::MinRankSum(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing)
+    : MatchingAlgorithm(G), rank_sum_(0)
+{}
+
+MinRankSum::~MinRankSum()
+{}
+
+bool MinRankSum::compute_matching() {
+    GraphIndex index(*get_graph());
+
+    // the rank of an edge is its cost, those from the source and to the
+    // sink cost nothing
+    AssignmentNetwork H(index);
+    rank_sum_ = 0;
+    H.compute_min_cost_flow(rank_sum_);
+
+    M_.clear();
+    H.get_matched_pairs(M_);
+
+    // a maximum matching always exists
+    return true;
+}
+
+CostType MinRankSum::get_rank_sum() const {
+    return rank_sum_;
+}
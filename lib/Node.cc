@@ -3,9 +3,9 @@
 Node::Node()
 {}
 
-Node::Node(IdType node_name, NodeType node_id) 
+Node::Node(IdType node_name, NodeType node_id, NodeRole role) 
 	: node_name_(node_name), node_id_(node_id),
-	  decomposition_label_("U")
+	  decomposition_label_(LABEL_U), role_(role)
 {}
 
 Node::~Node()
@@ -19,11 +19,18 @@ const NodeType& Node::get_id() const {
 	return node_id_;
 }
 
-const IdType& Node::get_decomposition_label() const {
+Node::DecompositionLabel Node::get_decomposition_label() const {
 	return decomposition_label_;
 }
 
-void Node::set_decomposition_label(IdType decomposition_label) {
+void Node::set_decomposition_label(DecompositionLabel decomposition_label) {
 	decomposition_label_ = decomposition_label;
 }
 
+Node::NodeRole Node::get_role() const {
+	return role_;
+}
+
+bool Node::is_post_leaf() const {
+	return role_ == ROLE_POST_LEAF || role_ == ROLE_LAST_RESORT_LEAF;
+}
\ No newline at end of file
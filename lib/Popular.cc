@@ -4,9 +4,34 @@
 #include "SReduction.h"
 #include "StableMarriage.h"
 #include "Utils.h"
+#include "ReducedGraphCache.h"
 #include <stack>
 #include <algorithm>
 
+namespace {
+
+// does some vertex rank two of its neighbours the same
+bool has_ties(const BipartiteGraph::ContainerType& vertices) {
+    for (const auto& it : vertices) {
+        auto& pref_list = it.second->get_preference_list();
+        RankType prev_rank = 0;
+
+        for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+            auto rank = pref_list.get_rank(*i);
+
+            if (i != pref_list.all_begin() and rank == prev_rank) {
+                return true;
+            }
+
+            prev_rank = rank;
+        }
+    }
+
+    return false;
+}
+
+}
+
 SPopular::SPopular(const std::unique_ptr<BipartiteGraph>& G,
                    int sbegin, int send, bool A_proposing)
     : MatchingAlgorithm(G), sbegin_(sbegin), send_(send), A_proposing_(A_proposing)
@@ -21,14 +46,15 @@ bool SPopular::compute_matching() {
     sbegin_ = send_;
 
     for (int s = sbegin_; s <= send_; s += 2) {
-        G_ = augment_graph(G, s);
-        StableMarriage sm(G_, A_proposing_);
+        G_ = G->get_reduced_graphs().get("s-reduction", s,
+                                         [&G, s] { return augment_graph(G, s); });
+        StableMarriage sm(*G_, A_proposing_);
 
         if (sm.compute_matching()) {
             const auto& M = sm.get_matched_pairs();
 
             // caller simply wants a matching for level-s
-            if (sbegin_ == send_ or not G_->has_augmenting_path(M)) {
+            if (sbegin_ == send_ or not (*G_)->has_augmenting_path(M)) {
                 M_tmp_ = M;
                 return true;
             }
@@ -44,3 +70,54 @@ bool SPopular::compute_matching() {
 MatchedPairListType& SPopular::get_matched_pairs() {
     return map_inverse(M_tmp_);
 }
+
+bool SPopular::get_witness(PopularityWitness& witness) {
+    const std::unique_ptr<BipartiteGraph>& G = get_graph();
+
+    // the levels only certify popularity when the preferences are strict
+    if (not G_ or send_ > 2 or has_ties(G->get_A_partition()) or
+        has_ties(G->get_B_partition()))
+    {
+        return false;
+    }
+
+    // the witness is only handed out once every seat has been set
+    PopularityWitness level_witness;
+
+    for (auto it : M_tmp_) {
+        auto u = it.first;
+
+        // only look at the copies of vertices from A
+        const auto& A = (*G_)->get_A_partition();
+        auto uit = A.find(u->get_id());
+        if (uit == A.end() or uit->second != u) {
+            continue;
+        }
+
+        auto a = u->get_origin();
+        auto alpha = u->get_level() == 0 ? 1 : -1;
+        auto& partners = it.second;
+
+        for (auto i = partners.begin(), e = partners.end(); i != e; ++i) {
+            auto v = partners.get_vertex(i);
+
+            if (not v->is_dummy()) {
+                auto b = v->get_origin();
+                auto& pref_list = b->get_preference_list();
+
+                // a vertex of B with an empty list does not vote, so its
+                // seat cannot have alpha -1, and with alpha 0 the sum of
+                // the alphas would be positive
+                if (alpha == 1 and pref_list.all_begin() == pref_list.all_end()) {
+                    return false;
+                }
+
+                level_witness.set_alpha(a, b, alpha);
+                level_witness.set_alpha(b, a, -alpha);
+            }
+        }
+    }
+
+    witness = level_witness;
+    return true;
+}
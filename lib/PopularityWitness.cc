@@ -0,0 +1,110 @@
+#include "PopularityWitness.h"
+#include "Vertex.h"
+#include <sstream>
+#include <stdexcept>
+
+PopularityWitness::PopularityWitness()
+{}
+
+PopularityWitness::~PopularityWitness()
+{}
+
+void PopularityWitness::set_alpha(const VertexPtr& u, const VertexPtr& v,
+                                  AlphaType alpha)
+{
+    seats_[u][v] = alpha;
+}
+
+PopularityWitness::AlphaType
+PopularityWitness::get_alpha(const VertexPtr& u, const VertexPtr& v) const {
+    auto it = seats_.find(u);
+
+    if (it != seats_.end()) {
+        auto sit = it->second.find(v);
+
+        if (sit != it->second.end()) {
+            return sit->second;
+        }
+    }
+
+    return 0;
+}
+
+void PopularityWitness::set_free_alpha(const VertexPtr& u, AlphaType alpha) {
+    free_seats_[u] = alpha;
+}
+
+PopularityWitness::AlphaType PopularityWitness::get_free_alpha(const VertexPtr& u) const {
+    auto it = free_seats_.find(u);
+    return it == free_seats_.end() ? 0 : it->second;
+}
+
+void PopularityWitness::write(const std::unique_ptr<BipartiteGraph>& G,
+                              std::ostream& out) const
+{
+    auto write_partition = [this, &out] (const BipartiteGraph::ContainerType& vertices,
+                                         char partition)
+    {
+        for (const auto& it : vertices) {
+            const auto& u = it.second;
+            auto sit = seats_.find(u);
+
+            if (sit != seats_.end()) {
+                for (const auto& seat : sit->second) {
+                    out << partition << ',' << u->get_id() << ','
+                        << seat.first->get_id() << ',' << seat.second << '\n';
+                }
+            }
+
+            if (get_free_alpha(u) != 0) {
+                out << partition << ',' << u->get_id() << ",,"
+                    << get_free_alpha(u) << '\n';
+            }
+        }
+    };
+
+    write_partition(G->get_A_partition(), 'A');
+    write_partition(G->get_B_partition(), 'B');
+}
+
+void PopularityWitness::read(const std::unique_ptr<BipartiteGraph>& G,
+                             std::istream& in)
+{
+    const auto& A = G->get_A_partition();
+    const auto& B = G->get_B_partition();
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        // partition,u,v,alpha
+        std::stringstream stmp(line);
+        std::string partition, u_id, v_id, alpha;
+        std::getline(stmp, partition, ',');
+        std::getline(stmp, u_id, ',');
+        std::getline(stmp, v_id, ',');
+        std::getline(stmp, alpha);
+
+        const auto& U = partition == "A" ? A : B;
+        const auto& V = partition == "A" ? B : A;
+        auto u = U.find(u_id);
+
+        if ((partition != "A" and partition != "B") or u == U.end()) {
+            throw std::runtime_error("invalid witness entry " + line);
+        }
+
+        if (v_id.empty()) {
+            set_free_alpha(u->second, std::atoi(alpha.c_str()));
+        } else {
+            auto v = V.find(v_id);
+
+            if (v == V.end()) {
+                throw std::runtime_error("invalid witness entry " + line);
+            }
+
+            set_alpha(u->second, v->second, std::atoi(alpha.c_str()));
+        }
+    }
+}
@@ -5,6 +5,8 @@
 #include "PartnerList.h"
 #include "TDefs.h"
 #include "Utils.h"
+#include "SReduction.h"
+#include "ReducedGraphCache.h"
 #include <algorithm>
 
 RHeuristicHRLQ::RHeuristicHRLQ(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing)
@@ -15,8 +17,12 @@ RHeuristicHRLQ::~RHeuristicHRLQ()
 {}
 
 bool RHeuristicHRLQ::compute_matching() {
-    G1_ = augment_phase1();
-    PopularAmongMaxCard pamc(G1_);
+    // phase 1 runs on the graph restricted to the lower quota hospitals,
+    // which is shared with the other algorithms through the cache of G
+    const std::unique_ptr<BipartiteGraph>& G = get_graph();
+    G1_ = G->get_reduced_graphs().get("lower-quota", 0,
+                                      [&G] { return augment_lower_quota_graph(G); });
+    PopularAmongMaxCard pamc(*G1_);
 
     if (pamc.compute_matching()) {
         G2_ = augment_phase2(pamc.get_matched_pairs());
@@ -40,64 +46,6 @@ MatchedPairListType& RHeuristicHRLQ::get_matched_pairs() {
     return M_tmp_;
 }
 
-std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase1() {
-    BipartiteGraph::ContainerType A, B;
-    const std::unique_ptr<BipartiteGraph>& G = get_graph();
-
-    // add only those vertices from partition B which have lower quota > 0
-    for (auto it : G->get_B_partition()) {
-        auto v = it.second;
-
-        if (v->get_lower_quota() > 0) {
-            auto u_id = v->get_id();
-            auto u = std::make_shared<Vertex>(u_id, 0, v->get_lower_quota());
-
-            // add this vertex to partition B
-            B.emplace(u_id, u);
-
-            // preference list of this vertex is same as in G
-            auto& v_pref_list = v->get_preference_list();
-            auto& u_pref_list = u->get_preference_list();
-
-            for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
-                 i != e; ++i)
-            {
-                auto r_old = v_pref_list.get_vertex(*i);
-                auto r_id = r_old->get_id();
-                auto r = std::make_shared<Vertex>(r_id,
-                            r_old->get_lower_quota(), r_old->get_upper_quota());
-
-                // add the neighbouring vertex to A as well
-                A.emplace(r_id, r);
-                u_pref_list.emplace_back(r);
-            }
-        }
-    }
-
-    // settle preferences for the residents in the new graph
-    auto& A_old = G->get_A_partition();
-
-    for (auto it : A) {
-        auto r = it.second;
-        auto r_old = A_old.at(r->get_id());
-        auto& r_pref_list = r->get_preference_list();
-        auto& old_pref_list = r_old->get_preference_list();
-
-        for (auto i = old_pref_list.all_begin(), e = old_pref_list.all_end();
-             i != e; ++i)
-        {
-            // only add vertices with lower quota > 0
-            auto h_old = old_pref_list.get_vertex(*i);
-            if (h_old->get_lower_quota() > 0) {
-                r_pref_list.emplace_back(B.at(h_old->get_id()));
-            }
-        }
-
-    }
-
-    return std::make_unique<BipartiteGraph>(A, B);
-}
-
 std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListType& M) {
     /// the matching M passed to this function is a matching in the graph G1_
     /// and not in the original graph G, therefore trying to get the matched
@@ -125,6 +73,7 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
         auto v = it.second;
         auto u_id = v->get_id();
         auto u = std::make_shared<Vertex>(u_id, 0, v->get_upper_quota());
+        u->set_origin(v, 0);
 
         // add this vertex to partition B
         B.emplace(u_id, u);
@@ -138,10 +87,11 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
         // create a resident with the same preferences in the new graph
         auto r = std::make_shared<Vertex>(v_id,
                           v->get_lower_quota(), v->get_upper_quota());
+        r->set_origin(v, 1);
         // add this vertex to partition A
         A.emplace(v_id, r);
 
-        auto v_G1 = find_vertex(G1_, v_id);
+        auto v_G1 = find_vertex(*G1_, v_id);
         const auto& M_v = M.find(v_G1);
 
         // if this vertex has a partner, create a new resident and a dummy
@@ -151,6 +101,7 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
             const auto& r0_id = get_vertex_id(v_id, 0);
             auto r0 = std::make_shared<Vertex>(r0_id, v_id,
                         v->get_lower_quota(), v->get_upper_quota(), false);
+            r0->set_origin(v, 0);
 
             // add this vertex to partition A
             A.emplace(r0_id, r0);
@@ -170,20 +121,21 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
             dummy_pref_list.emplace_back(r);
 
             // add this dummy at the beginning of the preference list of r
-            r->get_preference_list().emplace_back(dummy);
+            r->emplace_back_with_origin(dummy, 0);
 
             // preference list r^0 : M(r), d^r
+            // the rank of M(r) in G1_ is mapped to its rank in G
             auto& v_partners = M_v->second;
-            auto& r0_pref_list = r0->get_preference_list();
-            auto partner = v_partners.get_vertex(v_partners.cbegin());
-            r0_pref_list.emplace_back(B.at(partner->get_id()));
-            r0_pref_list.emplace_back(dummy);
+            auto pit = v_partners.cbegin();
+            auto partner = v_partners.get_vertex(pit);
+            r0->emplace_back_with_origin(B.at(partner->get_id()),
+                    v_G1->get_origin_rank(v_partners.get_rank(pit)));
+            r0->emplace_back_with_origin(dummy, 0);
         }
 
         // for r, its preference is d^r followed by its original preference list
         // d^r has already been added to its preference list
         auto& v_pref_list = v->get_preference_list();
-        auto& r_pref_list = r->get_preference_list();
 
         for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end(); i != e; ++i) {
             // get the old neighbouring hospital
@@ -191,7 +143,7 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
             auto& h_id = h_old->get_id();
 
             // add h to r's preference list and the partition B
-            r_pref_list.emplace_back(B.at(h_id));
+            r->emplace_back_with_origin(B.at(h_id), v_pref_list.get_rank(*i));
         }
     }
 
@@ -205,11 +157,10 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
         // the preference list of this vertex is
         // all the residents in the original preference list followed by M(v)
         auto vertex = B.at(v_id);
-        auto& pref_list = vertex->get_preference_list();
 
         for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end(); i != e; ++i) {
             auto u = v_pref_list.get_vertex(*i);
-            pref_list.emplace_back(A.at(u->get_id()));
+            vertex->emplace_back_with_origin(A.at(u->get_id()), v_pref_list.get_rank(*i));
         }
 
         // if this hospital has partners, add their level-0 copy
@@ -217,7 +168,7 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
         // in phase 1, only the lower quota hospitals as in the original graph
         // G are present in the graph, and so only they can be matched
         if (v->get_lower_quota() > 0) {
-            auto v_G1 = find_vertex(G1_, v_id, false);
+            auto v_G1 = find_vertex(*G1_, v_id, false);
             const auto& M_v = M.find(v_G1);
 
             if (M_v != M.end()) {
@@ -229,7 +180,8 @@ std::unique_ptr<BipartiteGraph> RHeuristicHRLQ::augment_phase2(MatchedPairListTy
                 {
                     auto r = partner_list.get_vertex(pit);
                     const auto& r0_id = get_vertex_id(r->get_id(), 0);
-                    pref_list.emplace_back(A.at(r0_id));
+                    vertex->emplace_back_with_origin(A.at(r0_id),
+                            v_G1->get_origin_rank(partner_list.get_rank(pit)));
                 }
 
             }
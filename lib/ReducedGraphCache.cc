@@ -0,0 +1,107 @@
+#include "ReducedGraphCache.h"
+#include "Vertex.h"
+
+const std::size_t ReducedGraphCache::DEFAULT_CAPACITY;
+
+ReducedGraphCache::ReducedGraphCache(std::size_t capacity)
+    : capacity_(capacity), stats_{0, 0, 0, 0, 0}
+{}
+
+ReducedGraphCache::~ReducedGraphCache()
+{}
+
+ReducedGraphCache::GraphPtr ReducedGraphCache::get(const std::string& transformation,
+                                                   int parameter,
+                                                   const BuilderType& build)
+{
+    KeyType key(transformation, parameter);
+    auto it = entries_.find(key);
+
+    if (it != entries_.end()) {
+        // move the key to the front of the lru list
+        lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+        ++stats_.hits;
+        return it->second.graph;
+    }
+
+    ++stats_.misses;
+    GraphPtr graph = std::make_shared<const std::unique_ptr<BipartiteGraph>>(build());
+    std::size_t nbytes = estimate_size(**graph);
+
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{graph, nbytes, lru_.begin()});
+    stats_.nbytes += nbytes;
+    stats_.ngraphs += 1;
+    evict();
+
+    return graph;
+}
+
+void ReducedGraphCache::evict() {
+    // this may also drop the graph just added if it alone does not fit,
+    // the caller still holds it
+    while (stats_.nbytes > capacity_ and not lru_.empty()) {
+        auto it = entries_.find(lru_.back());
+
+        stats_.nbytes -= it->second.nbytes;
+        stats_.ngraphs -= 1;
+        ++stats_.evictions;
+
+        entries_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+void ReducedGraphCache::set_capacity(std::size_t capacity) {
+    capacity_ = capacity;
+    evict();
+}
+
+std::size_t ReducedGraphCache::get_capacity() const {
+    return capacity_;
+}
+
+void ReducedGraphCache::clear() {
+    entries_.clear();
+    lru_.clear();
+    stats_.nbytes = 0;
+    stats_.ngraphs = 0;
+}
+
+const ReducedGraphCache::Statistics& ReducedGraphCache::get_statistics() const {
+    return stats_;
+}
+
+std::size_t ReducedGraphCache::estimate_size(const BipartiteGraph& G) {
+    // a node in a map holding (id, vertex) has about four pointers of overhead
+    const std::size_t node_overhead = 4 * sizeof(void*);
+
+    auto partition_size = [&node_overhead] (const BipartiteGraph::ContainerType& vertices) {
+        std::size_t nbytes = 0;
+
+        for (const auto& it : vertices) {
+            const auto& v = it.second;
+            auto& pref_list = v->get_preference_list();
+            std::size_t nentries = pref_list.all_end() - pref_list.all_begin();
+
+            nbytes += node_overhead + sizeof(it) + sizeof(Vertex)
+                    + it.first.capacity() + v->get_id().capacity()
+                    + v->get_cloned_for_id().capacity()
+                    + nentries * (sizeof(PreferenceList::ElementType) + sizeof(RankType))
+                    + sizeof(VertexPtr); // the indexed view of the partition
+        }
+
+        return nbytes;
+    };
+
+    return sizeof(BipartiteGraph) + partition_size(G.get_A_partition())
+                                  + partition_size(G.get_B_partition());
+}
+
+std::ostream& operator<<(std::ostream& out, const ReducedGraphCache::Statistics& stats) {
+    return out << "reduced_graph_cache_hits," << stats.hits << '\n'
+               << "reduced_graph_cache_misses," << stats.misses << '\n'
+               << "reduced_graph_cache_evictions," << stats.evictions << '\n'
+               << "reduced_graph_cache_graphs," << stats.ngraphs << '\n'
+               << "reduced_graph_cache_bytes," << stats.nbytes << '\n';
+}
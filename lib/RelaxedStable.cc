@@ -1,11 +1,11 @@
 #include "RelaxedStable.h"
 #include "ClassifiedPopular.h"
-#include "Statistics.h"
 #include "Vertex.h"
 #include "PartnerList.h"
 #include "Utils.h"
 #include <stack>
 #include <map>
+#include <vector>
 #include <iostream>
 
 RelaxedStable::RelaxedStable(const std::unique_ptr<BipartiteGraph>& G,
@@ -18,55 +18,68 @@ RelaxedStable::~RelaxedStable()
 
 //check if output matching is relaxed stable
 bool RelaxedStable::is_relaxed_stable(const std::unique_ptr<BipartiteGraph>& G, MatchedPairListType& M) {
-    //map to maintain residents which are in blocking pair
-    std::map<VertexPtr, bool> in_blocking_pair;
+    const auto& A_partition = G->get_A_partition();
+    const auto& B_partition = G->get_B_partition();
+
+    //residents which are in blocking pair, by their index in G
+    std::vector<char> in_blocking_pair(A_partition.size(), false);
+
     //for each resident
-    auto A_partition = G->get_A_partition();
     for (auto& A1 : A_partition) {
-        auto u = A1.second;
-        in_blocking_pair[u] = false;
+        const auto& u = A1.second;
 
-        //u's preference list
+        //u's preference list and partners, if it has any
         PreferenceList& u_pref_list = u->get_preference_list();
-        auto u_partnerlist = M[u];
+        auto M_u = M.find(u);
+        bool u_matched = M_u != M.end() && !M_u->second.empty();
 
         //iterate through u's preference list
         for (PreferenceList::Iterator it = u_pref_list.all_begin();
             it != u_pref_list.all_end(); ++it) {
             //hospital v from u's pref list to check if (u,v) is blocking pair
-            auto v = u_pref_list.get_vertex(it - u_pref_list.all_begin());
+            auto v = u_pref_list.get_vertex(*it);
 
             //if this hospital is matched to this resident then no need to check for later hospitals
-            if (u_partnerlist.find(v) != u_partnerlist.cend()) {
+            if (u_matched && M_u->second.find(v) != M_u->second.cend()) {
                 break;
             }
 
             PreferenceList& v_pref_list = v->get_preference_list();
-            auto v_partnerlist = M[v];
-            //if v is fully subscribed
-            if (v_partnerlist.size() == v->get_upper_quota()) {
+            auto M_v = M.find(v);
+            auto v_size = M_v == M.end() ? 0 : M_v->second.size();
+            //if v is fully subscribed (a hospital without seats never blocks)
+            if (v_size == v->get_upper_quota()) {
+                if (v_size == 0) {
+                    continue;
+                }
+
+                auto& v_partnerlist = M_v->second;
                 auto u_least_preferred = v_partnerlist.get_vertex(v_partnerlist.get_least_preferred());
                 if (v_pref_list.is_ranked_better(u_least_preferred, u)) {
                     continue;
                 }
             }
-            in_blocking_pair[u] = true;
+            in_blocking_pair[u->get_index()] = true;
         }
         // if u is unmatched and in blocking pair
-        if (u_partnerlist.size() == 0 && in_blocking_pair[u] == true) {
+        if (!u_matched && in_blocking_pair[u->get_index()]) {
             return false;
         }
     }
 
     //for each hospital
-    auto B_partition = G->get_B_partition();
     for (auto& B1 : B_partition) {
-        auto v = B1.second;
+        const auto& v = B1.second;
+        auto M_v = M.find(v);
+        if (M_v == M.end()) {
+            continue;
+        }
+
         auto v_lower_quota = v->get_lower_quota();
-        auto v_partnerlist = M[v];
+        auto& v_partnerlist = M_v->second;
         for (auto pit = v_partnerlist.cbegin(), pie = v_partnerlist.cend(); pit != pie; ++pit) {
             auto u = v_partnerlist.get_vertex(pit);
-            if (in_blocking_pair[u] == true) {
+            if (in_blocking_pair[u->get_index()]) {
                 v_lower_quota = v_lower_quota - 1;
             }
         }
@@ -81,8 +94,8 @@ bool RelaxedStable::is_relaxed_stable(const std::unique_ptr<BipartiteGraph>& G,
 std::unique_ptr<BipartiteGraph> RelaxedStable::get_modified_graph() {
     //old graph and its partitions
     const std::unique_ptr<BipartiteGraph>& G = get_graph();
-    auto A_partition = G->get_A_partition();
-    auto B_partition = G->get_B_partition();
+    const auto& A_partition = G->get_A_partition();
+    const auto& B_partition = G->get_B_partition();
 
     //partitions of new graph
     BipartiteGraph::ContainerType A, B;
@@ -118,15 +131,15 @@ std::unique_ptr<BipartiteGraph> RelaxedStable::get_modified_graph() {
 bool RelaxedStable::compute_matching() {
     
     const std::unique_ptr<BipartiteGraph>& G = get_graph();
-    auto A_partition = G->get_A_partition();
-    auto B_partition = G->get_B_partition();
+    const auto& A_partition = G->get_A_partition();
+    const auto& B_partition = G->get_B_partition();
 
     //For finding minimal feasible matching we need modified graph
     const std::unique_ptr<BipartiteGraph>& G1 = get_modified_graph();
     ClassifiedPopular alg(G1, A_proposing_);
     if (alg.compute_matching()) {
         //output matching of classified popular class
-        MatchedPairListType M1_ = alg.get_matched_pairs();
+        const MatchedPairListType& M1_ = alg.get_matched_pairs();
 
         //construct the above matching for the original graph with original ranks
         for (auto& it : G1->get_B_partition()) {
@@ -134,14 +147,14 @@ bool RelaxedStable::compute_matching() {
             auto M_u = M1_.find(u);
             if (M_u != M1_.end()) {
                 //getting new vertex data
-                auto u_new = B_partition[u->get_id()];
+                const auto& u_new = B_partition.find(u->get_id())->second;
                 auto& u_new_pref_list = u_new->get_preference_list();
                 auto& u_new_partner_list = M_[u_new];
 
                 auto& partners = M_u->second;
                 for (auto pit = partners.cbegin(), pie = partners.cend(); pit != pie; ++pit) {
                     auto v = partners.get_vertex(pit);
-                    auto v_new = A_partition[v->get_id()];
+                    const auto& v_new = A_partition.find(v->get_id())->second;
                     auto& v_new_pref_list = v_new->get_preference_list();
                     auto& v_new_partner_list = M_[v_new];
 
@@ -161,10 +174,15 @@ bool RelaxedStable::compute_matching() {
         //After finding minimal feasible matching
         std::map<VertexPtr, int> level;
         std::stack<VertexPtr> free_list;
+
+        // proposal index of the residents, by their index in G
+        std::vector<PreferenceList::SizeType> proposal_index(A_partition.size());
+
         //Add each unmatched resident to free_list
         for (auto& A1 : A_partition) {
             auto v = A1.second;
             level[v] = 0;
+            proposal_index[v->get_index()] = v->get_preference_list().begin();
             //if resident is unmatched add to freelist and make level 1
             if (M_.find(v) == M_.end()) {
                 free_list.push(v);
@@ -178,12 +196,13 @@ bool RelaxedStable::compute_matching() {
             auto u = free_list.top();
             auto& u_pref_list = u->get_preference_list();
             auto& u_partner_list = M_[u];
+            auto& u_proposal_index = proposal_index[u->get_index()];
             free_list.pop();
 
             // if resident did not exhaust its preference list
-            if (!u_pref_list.empty()) {
+            if (u_proposal_index < u_pref_list.end()) {
                 // highest ranked vertex to whom u not yet proposed
-                auto v = u_pref_list.get_vertex(u_pref_list.get_proposal_index());
+                auto v = u_pref_list.get_vertex(u_proposal_index);
 
                 // v's preference list and list of partners
                 auto& v_pref_list = v->get_preference_list();
@@ -193,7 +212,7 @@ bool RelaxedStable::compute_matching() {
                 auto u_rank = v_pref_list.get_rank(v_pref_list.find(u));
                 
                 // v's rank on u's preference list
-                auto v_rank = u_pref_list.get_rank(u_pref_list.get_proposal_index());
+                auto v_rank = u_pref_list.get_rank(u_proposal_index);
                 
                 // if v is undersubscribed
                 if (v_partner_list.size() < v->get_upper_quota()) {
@@ -260,12 +279,10 @@ bool RelaxedStable::compute_matching() {
                         }
                     }
                 }
-                u_pref_list.move_proposal_index();
+                ++u_proposal_index;
             }
         }
 
-        Statistics s;
-        s.get_statistics(G, M_);
         //if (is_relaxed_stable(G, M_)) {
         //    std::cout << "Relaxed stable\n";
         //}
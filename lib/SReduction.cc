@@ -15,6 +15,7 @@ std::unique_ptr<BipartiteGraph> augment_graph(
         auto u_id = v->get_id();
         auto u = std::make_shared<Vertex>(u_id,
                         v->get_lower_quota(), v->get_upper_quota());
+        u->set_origin(v, 0);
 
         // add this vertex to partition B
         B.emplace(u_id, u);
@@ -42,7 +43,7 @@ std::unique_ptr<BipartiteGraph> augment_graph(
             const auto& u_id = get_vertex_id(v_id, k);
             auto u = std::make_shared<Vertex>(u_id, v_id,
                         v->get_lower_quota(), v->get_upper_quota(), false);
-            auto& u_pref_list = u->get_preference_list();
+            u->set_origin(v, k);
 
             // add this vertex to partition A
             A.emplace(u_id, u);
@@ -54,36 +55,39 @@ std::unique_ptr<BipartiteGraph> augment_graph(
                      i != e; ++i)
                 {
                     auto neighbour = v_pref_list.get_vertex(*i);
-                    u_pref_list.emplace_back(B.at(neighbour->get_id()));
+                    u->emplace_back_with_origin(B.at(neighbour->get_id()),
+                                                v_pref_list.get_rank(*i));
                 }
 
                 const auto& dummy_0 = get_dummy_id(v_id, 0);
-                u_pref_list.emplace_back(B.at(dummy_0));
+                u->emplace_back_with_origin(B.at(dummy_0), 0);
             } else if (k == (s-1)) {
                 // for a level-(s-1) vertex, its preference is d^(s-2)_m followed
                 // by the original preference list
                 const auto& dummy_s_2 = get_dummy_id(v_id, s-2);
-                u_pref_list.emplace_back(B.at(dummy_s_2));
+                u->emplace_back_with_origin(B.at(dummy_s_2), 0);
 
                 for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
                      i != e; ++i)
                 {
                     auto neighbour = v_pref_list.get_vertex(*i);
-                    u_pref_list.emplace_back(B.at(neighbour->get_id()));
+                    u->emplace_back_with_origin(B.at(neighbour->get_id()),
+                                                v_pref_list.get_rank(*i));
                 }
             } else { // 1 <= k <= s-2
                 const auto& dummy_k_1 = get_dummy_id(v_id, k-1);
-                u_pref_list.emplace_back(B.at(dummy_k_1));
+                u->emplace_back_with_origin(B.at(dummy_k_1), 0);
 
                 for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
                      i != e; ++i)
                 {
                     auto neighbour = v_pref_list.get_vertex(*i);
-                    u_pref_list.emplace_back(B.at(neighbour->get_id()));
+                    u->emplace_back_with_origin(B.at(neighbour->get_id()),
+                                                v_pref_list.get_rank(*i));
                 }
 
                 const auto& dummy_k = get_dummy_id(v_id, k);
-                u_pref_list.emplace_back(B.at(dummy_k));
+                u->emplace_back_with_origin(B.at(dummy_k), 0);
             }
         }
     }
@@ -98,7 +102,6 @@ std::unique_ptr<BipartiteGraph> augment_graph(
         // all the level-(s-1) vertices, followed by level-(s-2) residents
         // and so on, in the same order as the original preference list
         auto vertex = B.at(v->get_id());
-        auto& pref_list = vertex->get_preference_list();
 
         for (int k = (s-1); k >= 0; --k) {
            for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
@@ -106,7 +109,8 @@ std::unique_ptr<BipartiteGraph> augment_graph(
            {
                auto u = v_pref_list.get_vertex(*i);
                const auto& u_k_id = get_vertex_id(u->get_id(), k);
-               pref_list.emplace_back(A.at(u_k_id));
+               vertex->emplace_back_with_origin(A.at(u_k_id),
+                                                v_pref_list.get_rank(*i));
            }
         }
     }
@@ -131,3 +135,65 @@ std::unique_ptr<BipartiteGraph> augment_graph(
     return std::make_unique<BipartiteGraph>(A, B);
 }
 
+std::unique_ptr<BipartiteGraph> augment_lower_quota_graph(
+        const std::unique_ptr<BipartiteGraph>& G)
+{
+    BipartiteGraph::ContainerType A, B;
+
+    // add all vertices from partition B / hospitals
+    for (auto it : G->get_B_partition()) {
+        auto v = it.second;
+
+        // only keep vertices in B with > 0 lower quota
+        if (v->get_lower_quota() > 0) {
+            // create a new vertex with quota (0, l_h)
+            auto u_id = v->get_id();
+            auto u = std::make_shared<Vertex>(u_id, 0, v->get_lower_quota());
+            u->set_origin(v, 0);
+
+            // add this vertex to partition B
+            B.emplace(u_id, u);
+
+            // preference list of this vertex is same as in G
+            auto& v_pref_list = v->get_preference_list();
+
+            // copy the preference list as it is
+            for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
+                    i != e; ++i)
+            {
+                auto r_old = v_pref_list.get_vertex(*i);
+                auto r_id = r_old->get_id();
+                auto r = std::make_shared<Vertex>(r_id,
+                            r_old->get_lower_quota(), r_old->get_upper_quota());
+                r->set_origin(r_old, 0);
+
+                // add the neighbouring vertex to A as well
+                A.emplace(r_id, r);
+                u->emplace_back_with_origin(r, v_pref_list.get_rank(*i));
+            }
+        }
+    }
+
+    // settle preferences for the residents in the new graph
+    auto& A_old = G->get_A_partition();
+
+    for (auto it : A) {
+        auto r = it.second;
+        auto r_old = A_old.at(r->get_id());
+        auto& old_pref_list = r_old->get_preference_list();
+
+        for (auto i = old_pref_list.all_begin(), e = old_pref_list.all_end();
+             i != e; ++i)
+        {
+            auto h_old = old_pref_list.get_vertex(*i);
+
+            // add this vertex to pref list only if it has a positive lower quota
+            if (h_old->get_lower_quota() > 0) {
+                r->emplace_back_with_origin(B.at(h_old->get_id()),
+                                            old_pref_list.get_rank(*i));
+            }
+        }
+    }
+
+    return std::make_unique<BipartiteGraph>(A, B);
+}
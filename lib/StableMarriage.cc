@@ -3,6 +3,7 @@
 #include "PartnerList.h"
 #include <stack>
 #include <map>
+#include <vector>
 
 StableMarriage::StableMarriage(const std::unique_ptr<BipartiteGraph>& G,
                                bool A_proposing)
@@ -16,8 +17,9 @@ bool StableMarriage::compute_matching() {
     /// we do not assume that the proposal index starts at 0
     /// in the algorithm below, this is to cover the case when
     /// one would like to restart the algorithm at a particular place
-    /// if you want to get a stable matching from scratch make sure
-    /// that the graph provided is pristine
+    /// the proposal index of every vertex starts at the beginning of its
+    /// preference list and is kept here, so that the graph is not modified
+    /// and can be shared with other algorithms
     std::stack<VertexPtr> free_list;
     std::map<VertexPtr, int> in_queue;
     const std::unique_ptr<BipartiteGraph>& G = get_graph();
@@ -26,24 +28,29 @@ bool StableMarriage::compute_matching() {
     const auto& proposing_partition = A_proposing_ ? G->get_A_partition()
                                                    : G->get_B_partition();
 
+    // proposal index of the proposing vertices, by their index in G
+    std::vector<PreferenceList::SizeType> proposal_index(proposing_partition.size());
+
     // mark all proposing vertices free (by pushing into the free_list)
     // and vertices from the opposite partition implicitly free
     for (auto it : proposing_partition) {
         free_list.push(it.second);
         in_queue[it.second] = 1;
+        proposal_index[it.second->get_index()] = it.second->get_preference_list().begin();
     }
 
     while (not free_list.empty()) {
         auto u = free_list.top();
         auto& u_pref_list = u->get_preference_list();
         auto& u_partner_list = M_[u];
+        auto& u_proposal_index = proposal_index[u->get_index()];
         free_list.pop(); // remove u from free_list
         in_queue[u] = 0;
 
         // if the preferences of u have not been exhausted
-        if (not u_pref_list.empty()) {
+        if (u_proposal_index < u_pref_list.end()) {
             // highest ranked vertex to whom u not yet proposed
-            auto v = u_pref_list.get_vertex(u_pref_list.get_proposal_index());
+            auto v = u_pref_list.get_vertex(u_proposal_index);
 
             // v's preference list and list of partners
             auto& v_pref_list = v->get_preference_list();
@@ -53,7 +60,7 @@ bool StableMarriage::compute_matching() {
             auto u_rank = v_pref_list.get_rank(v_pref_list.find(u));
 
             // v's rank on u's preference list
-            auto v_rank = u_pref_list.get_rank(u_pref_list.get_proposal_index());
+            auto v_rank = u_pref_list.get_rank(u_proposal_index);
 
             if (v_partner_list.size() == v->get_upper_quota()) {
                 // v's least preferred partner
@@ -91,7 +98,7 @@ bool StableMarriage::compute_matching() {
             // add u to the free_list if it has residual capacity
             if (u->get_upper_quota() > u_partner_list.size() and in_queue[u] == 0) {
                 // set the proposing index to the next vertex
-                u_pref_list.move_proposal_index();
+                ++u_proposal_index;
                 free_list.push(u);
                 in_queue[u] = 1;
             }
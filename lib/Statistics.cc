@@ -1,143 +1,245 @@
 #include "Statistics.h"
-#include "StableMarriage.h"
+#include "Parallel.h"
 #include "Vertex.h"
 #include "PartnerList.h"
-#include "Utils.h"
-#include <map>
-#include <iostream>
-
-Statistics::Statistics()
-{
-    //initially set all statistics to zero
-    S = 0;
-    BPC = 0;
-    BR = 0;
-    R1 = 0;
-    def = 0;
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+//position of a resident who is not on the preference list of a hospital
+const IndexType UNLISTED = std::numeric_limits<IndexType>::max();
+
+//rank of a resident who is not on the preference list of a hospital,
+//worse than any other as for PreferenceList::get_rank
+const RankType RANK_UNLISTED = std::numeric_limits<RankType>::max();
+
+RankType get_B_rank(const GraphIndex& index, IndexType e) {
+    auto rank = index.get_B_rank(e);
+    return rank == GraphIndex::UNRANKED ? RANK_UNLISTED : rank;
+}
+
+//statistics of the residents of a block
+struct ResidentCounts {
+    unsigned long int S, BPC, BR, R1;
+    std::vector<unsigned long int> rank_profile;
+};
+
 }
 
+Statistics::Statistics(const BipartiteGraph& G)
+    : index_(G), has_deficiency_(false), def_(0), sum_of_lower_quota_(0)
+{}
+
 Statistics::~Statistics()
 {}
 
-//duplicating graph to input to stable matching
-std::unique_ptr<BipartiteGraph> Statistics::get_duplicate_graph(const std::unique_ptr<BipartiteGraph>& G) {
-    //old graph partitions
-    auto A_partition = G->get_A_partition();
-    auto B_partition = G->get_B_partition();
+void Statistics::compute_deficiency() {
+    const auto& B = index_.get_graph().get_B_vertices();
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+    IndexType m = index_.num_edges();
+
+    //position of the resident of every edge on the preference list of its
+    //hospital, edge_of[a] is the edge (a, b) while b is looked at
+    GraphIndex::IndexListType position(m, UNLISTED), edge_of(nA, m);
+    for (IndexType b = 0; b < nB; ++b) {
+        for (auto i = index_.B_begin(b); i < index_.B_end(b); ++i) {
+            edge_of[index_.get_tail(index_.B_edge(i))] = index_.B_edge(i);
+        }
 
-    //partitions of new graph
-    BipartiteGraph::ContainerType A, B;
+        PreferenceList& pref_list = B[b]->get_preference_list();
+        IndexType pos = 0;
+        for (auto it = pref_list.all_begin(); it != pref_list.all_end(); ++it, ++pos) {
+            auto u = pref_list.get_vertex(*it);
+            if (index_.is_A_vertex(u) and edge_of[u->get_index()] != m) {
+                position[edge_of[u->get_index()]] = pos;
+            }
+        }
 
-    //for each resident create a new vertex and place it in new graph
-    for (auto& A1 : A_partition) {
-        A.emplace(A1.first, std::make_shared<Vertex>(A1.first, A1.second->get_lower_quota(), A1.second->get_upper_quota()));
+        for (auto i = index_.B_begin(b); i < index_.B_end(b); ++i) {
+            edge_of[index_.get_tail(index_.B_edge(i))] = m;
+        }
     }
-    //for each hospital create a new vertex and place it in new graph
-    for (auto& B1 : B_partition) {
-        B.emplace(B1.first, std::make_shared<Vertex>(B1.first, B1.second->get_lower_quota(), B1.second->get_upper_quota()));
+
+    //resident proposing stable matching, a resident proposes along its
+    //edges and every hospital keeps its worst resident on top
+    GraphIndex::IndexListType next(nA), matched(nA, 0), free_list;
+    std::vector<std::priority_queue<std::pair<IndexType, IndexType>>> residents(nB);
+    for (IndexType a = 0; a < nA; ++a) {
+        next[a] = index_.A_begin(a);
+        free_list.push_back(a);
     }
-    //for each resident in new graph create a new preference list
-    for (auto& A1 : A_partition) {
-        VertexPtr v = A[A1.first];
-        PreferenceList& new_pref_list = v->get_preference_list();
-        PreferenceList& pref_list = A1.second->get_preference_list();
-        for (PreferenceList::Iterator it = pref_list.all_begin();
-            it != pref_list.all_end(); ++it) {
-            //create new pref list
-            new_pref_list.emplace_back(B[it->second->get_id()]);
+
+    while (not free_list.empty()) {
+        auto a = free_list.back();
+        if (matched[a] == index_.get_A_quota(a) or next[a] == index_.A_end(a)) {
+            free_list.pop_back();
+            continue;
+        }
+
+        auto e = next[a]++;
+        auto b = index_.get_head(e);
+        auto& b_residents = residents[b];
+        if (position[e] == UNLISTED or index_.get_B_quota(b) == 0) {
+            continue;
+        }
+
+        if (b_residents.size() < index_.get_B_quota(b)) {
+            b_residents.emplace(position[e], a);
+            ++matched[a];
+        } else if (position[e] < b_residents.top().first) {
+            //b prefers a to its worst resident, who becomes free
+            auto uc = b_residents.top().second;
+            b_residents.pop();
+            b_residents.emplace(position[e], a);
+            ++matched[a];
+            --matched[uc];
+            free_list.push_back(uc);
         }
     }
-    //for each hospital in new graph create a new preference list
-    for (auto& B1 : B_partition) {
-        VertexPtr v = B[B1.first];
-        PreferenceList& new_pref_list = v->get_preference_list();
-        PreferenceList& pref_list = B1.second->get_preference_list();
-        for (PreferenceList::Iterator it = pref_list.all_begin();
-            it != pref_list.all_end(); ++it) {
-            //create new pref list
-            new_pref_list.emplace_back(A[it->second->get_id()]);
+
+    //the hospitals below their lower quotas in the stable matching
+    for (IndexType b = 0; b < nB; ++b) {
+        unsigned long int v_lower_quota = B[b]->get_lower_quota();
+        sum_of_lower_quota_ += v_lower_quota;
+        if (residents[b].size() < v_lower_quota) {
+            def_ += v_lower_quota - residents[b].size();
         }
     }
-    return std::make_unique<BipartiteGraph>(A, B);
+
+    has_deficiency_ = true;
 }
 
 //To get the statistics of matching with respect to graph
-void Statistics::get_statistics(const std::unique_ptr<BipartiteGraph>& G, MatchedPairListType& M) {
-    
-    std::map<VertexPtr, bool> in_blocking_pair;
-    //for each resident
-    auto A_partition = G->get_A_partition();
-    for (auto& A1 : A_partition) {
-        auto u = A1.second;
-        in_blocking_pair[u] = false;
-        PreferenceList& u_pref_list = u->get_preference_list();
-        auto u_partnerlist = M[u];
-
-        //iterate through u's preference list
-        for (PreferenceList::Iterator it = u_pref_list.all_begin();
-            it != u_pref_list.all_end(); ++it) {
-
-            //hospital from u's pref list to check if (u,v) is blocking pair
-            auto v = u_pref_list.get_vertex(it - u_pref_list.all_begin());
-            //if this hospital is matched to this resident then no need to check for later hospitals
-            if (u_partnerlist.find(v) != u_partnerlist.cend()) {
-                // v's rank on u's preference list
-                auto v_rank = u_pref_list.get_rank(it - u_pref_list.all_begin());
-                //if v is ranked 1 in u's preference list
-                if (v_rank == 1) {
-                    R1++;
+Statistics::Metrics Statistics::get_statistics(const MatchedPairListType& M) {
+    if (not has_deficiency_) {
+        compute_deficiency();
+    }
+
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+    IndexType m = index_.num_edges();
+
+    //the matched edges, and the residents with a partner
+    std::vector<char> in_matching(m, 0), has_partner(nA, 0);
+    GraphIndex::IndexListType edge_of(nB, m);
+    for (const auto& it : M) {
+        const auto& u = it.first;
+        if (not index_.is_A_vertex(u) or it.second.size() == 0) {
+            continue;
+        }
+
+        auto a = u->get_index();
+        has_partner[a] = 1;
+        for (auto e = index_.A_begin(a); e < index_.A_end(a); ++e) {
+            edge_of[index_.get_head(e)] = e;
+        }
+
+        const auto& partners = it.second;
+        for (auto i = partners.cbegin(); i != partners.cend(); ++i) {
+            auto v = partners.get_vertex(i);
+            if (index_.is_B_vertex(v) and edge_of[v->get_index()] != m) {
+                in_matching[edge_of[v->get_index()]] = 1;
+            }
+        }
+
+        for (auto e = index_.A_begin(a); e < index_.A_end(a); ++e) {
+            edge_of[index_.get_head(e)] = m;
+        }
+    }
+
+    //number of residents of every hospital, and the rank of its least
+    //preferred one
+    GraphIndex::IndexListType num_partners(nB, 0);
+    std::vector<RankType> worst_rank(nB, 0);
+    parallel_for(nB, [&] (unsigned, IndexType begin, IndexType end) {
+        for (auto b = begin; b < end; ++b) {
+            for (auto i = index_.B_begin(b); i < index_.B_end(b); ++i) {
+                auto e = index_.B_edge(i);
+                if (in_matching[e]) {
+                    ++num_partners[b];
+                    worst_rank[b] = std::max(worst_rank[b], get_B_rank(index_, e));
                 }
-                break;
             }
+        }
+    });
+
+    std::vector<ResidentCounts> counts(parallel_blocks(nA), ResidentCounts{0, 0, 0, 0, {}});
+    parallel_for(nA, [&] (unsigned block, IndexType begin, IndexType end) {
+        auto& count = counts[block];
+
+        for (auto a = begin; a < end; ++a) {
+            bool in_blocking_pair = false;
+            bool matched_before = false;
+
+            //iterate through a's edges in the order of its preference list
+            for (auto e = index_.A_begin(a); e < index_.A_end(a); ++e) {
+                auto rank = index_.get_A_rank(e);
+                if (in_matching[e]) {
+                    if (not matched_before and rank == 1) {
+                        count.R1++;
+                    }
+                    if (count.rank_profile.size() < (std::size_t) rank) {
+                        count.rank_profile.resize(rank, 0);
+                    }
+                    count.rank_profile[rank - 1]++;
+                    matched_before = true;
+                }
 
-            PreferenceList& v_pref_list = v->get_preference_list();
-            auto v_partnerlist = M[v];
+                //if this hospital is matched to this resident then no need to check for later hospitals
+                if (matched_before) {
+                    continue;
+                }
 
-            //if v is fully subscribed  
-            if (v_partnerlist.size() == v->get_upper_quota()) {
-                auto u_least_preferred = v_partnerlist.get_vertex(v_partnerlist.get_least_preferred());
-                //if v doesnt prefer u to its least preferred then not a blocking pair
-                if (v_pref_list.is_ranked_better(u_least_preferred, u)) {
+                //if b is fully subscribed and does not prefer a to its
+                //least preferred resident then not a blocking pair
+                auto b = index_.get_head(e);
+                if (num_partners[b] == index_.get_B_quota(b) and
+                    worst_rank[b] < get_B_rank(index_, e)) {
                     continue;
                 }
+
+                in_blocking_pair = true;
+                count.BPC++;
+            }
+
+            if (has_partner[a]) {
+                count.S++;
+            }
+            if (in_blocking_pair) {
+                count.BR++;
             }
-            //if v is not fully subscribed or
-            //if v prefers u to its least preferred then (u,v) is a blocking pair
-            in_blocking_pair[u] = true;
-            //increment number of blocking pairs
-            BPC++;
         }
-        // if u is matched, increment size of matching
-        if (u_partnerlist.size() > 0) {
-            S++;
+    });
+
+    Metrics metrics{0, 0, 0, 0, def_, sum_of_lower_quota_, {}, {}, {}};
+    for (const auto& count : counts) {
+        metrics.S += count.S;
+        metrics.BPC += count.BPC;
+        metrics.BR += count.BR;
+        metrics.R1 += count.R1;
+
+        auto& profile = metrics.rank_profile;
+        if (profile.size() < count.rank_profile.size()) {
+            profile.resize(count.rank_profile.size(), 0);
         }
-        // if this resident is in some blocking pair
-        if (in_blocking_pair[u] == true) {
-            BR++;
+        for (std::size_t i = 0; i < count.rank_profile.size(); ++i) {
+            profile[i] += count.rank_profile[i];
         }
     }
 
-    //For finding stable matching we need duplicate graph
-    const std::unique_ptr<BipartiteGraph>& G1 = get_duplicate_graph(G);
-    StableMarriage alg(G1, false);
-    alg.compute_matching();
-    auto& M1 = alg.get_matched_pairs();
-
-    //for each hospital
-    auto B_partition = G1->get_B_partition();
-
-    unsigned long int sum_of_lower_quota = 0;
-    for (auto& B1 : B_partition) {
-        auto v = B1.second;
-        auto v_lower_quota = v->get_lower_quota();
-        sum_of_lower_quota += v_lower_quota;
-        auto v_partnerlist = M1[v];
-        if (v_partnerlist.size() < v_lower_quota) {
-            def += v_lower_quota - v_partnerlist.size();
+    const auto& B = index_.get_graph().get_B_vertices();
+    for (IndexType b = 0; b < nB; ++b) {
+        unsigned long int v_lower_quota = B[b]->get_lower_quota();
+        metrics.hospital_sizes.emplace_back(B[b]->get_id(), num_partners[b]);
+        if (num_partners[b] < v_lower_quota) {
+            metrics.lower_quota_deficits.emplace_back(B[b]->get_id(), v_lower_quota - num_partners[b]);
         }
     }
-    if (def > BR || BR > sum_of_lower_quota) {
-        std::cout << "wrong output\n";
-    }
-    std::cout << S << "," << BPC << "," << BR << "," << R1 << "," << def << ","<<sum_of_lower_quota<<"\n";
+
+    return metrics;
 }
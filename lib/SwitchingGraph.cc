@@ -0,0 +1,352 @@
+#include "SwitchingGraph.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const IndexType NONE = std::numeric_limits<IndexType>::max();
+
+}
+
+SwitchingGraph::SwitchingGraph(const BipartiteGraph& G, const MatchedPairListType& M)
+    : index_(G)
+{
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+    const auto& A = G.get_A_vertices();
+
+    // the first choices are the f-posts
+    is_f_post_.assign(num_posts(), false);
+    for (IndexType a = 0; a < nA; ++a) {
+        if (index_.A_begin(a) != index_.A_end(a)) {
+            is_f_post_[index_.get_head(index_.A_begin(a))] = true;
+        }
+    }
+
+    // f(a) and s(a) for every applicant, the last resort post of a is nB + a
+    IndexListType f(nA, NONE), s(nA, NONE);
+    for (IndexType a = 0; a < nA; ++a) {
+        auto begin = index_.A_begin(a), end = index_.A_end(a);
+
+        if (begin != end) {
+            f[a] = index_.get_head(begin);
+            s[a] = nB + a;
+
+            for (auto e = begin; e != end; ++e) {
+                if (not is_f_post_[index_.get_head(e)]) {
+                    s[a] = index_.get_head(e);
+                    break;
+                }
+            }
+        }
+    }
+
+    // M has to match every applicant to f(a) or s(a) and every f-post
+    std::vector<char> matched(num_posts(), false);
+    mate_.assign(nA, NONE);
+
+    for (IndexType a = 0; a < nA; ++a) {
+        auto it = M.find(A[a]);
+        auto p = nB + a;
+
+        if (it != M.end() and not it->second.empty()) {
+            auto b = it->second.get_vertex(it->second.cbegin());
+
+            if (not index_.is_B_vertex(b)) {
+                throw std::runtime_error("the partner of " + A[a]->get_id() + " is not a post");
+            }
+
+            p = b->get_index();
+        }
+
+        if ((f[a] == NONE and p != nB + a) or (f[a] != NONE and p != f[a] and p != s[a])) {
+            throw std::runtime_error("the matching is not popular, " + A[a]->get_id() +
+                                     " is not matched to its f-post or s-post");
+        } else if (matched[p]) {
+            throw std::runtime_error("the post matched to " + A[a]->get_id() +
+                                     " is matched more than once");
+        }
+
+        matched[p] = true;
+        mate_[a] = p;
+    }
+
+    for (IndexType p = 0; p < nB; ++p) {
+        if (is_f_post_[p] and not matched[p]) {
+            throw std::runtime_error("the matching is not popular, an f-post is not matched");
+        }
+    }
+
+    // the edge from M(a) to the other post of a
+    out_.assign(num_posts(), NONE);
+    applicant_.assign(num_posts(), NONE);
+
+    for (IndexType a = 0; a < nA; ++a) {
+        if (f[a] != NONE) {
+            out_[mate_[a]] = mate_[a] == f[a] ? s[a] : f[a];
+            applicant_[mate_[a]] = a;
+        }
+    }
+
+    // follow the edges from every post to find the components, a walk ends
+    // at a sink, in a cycle or at a post whose component is known
+    IndexListType comp(num_posts(), NONE), comp_sink, path;
+    std::vector<char> on_path(num_posts(), false);
+
+    for (IndexType v = 0; v < num_posts(); ++v) {
+        auto u = v;
+        path.clear();
+
+        while (u != NONE and comp[u] == NONE and not on_path[u]) {
+            on_path[u] = true;
+            path.emplace_back(u);
+            u = out_[u];
+        }
+
+        IndexType c = comp_sink.size();
+        if (u == NONE) {
+            comp_sink.emplace_back(path.back());
+        } else if (on_path[u]) {
+            comp_sink.emplace_back(NONE);
+            cycles_.emplace_back(u);
+        } else {
+            c = comp[u];
+        }
+
+        for (auto w : path) {
+            comp[w] = c;
+            on_path[w] = false;
+        }
+    }
+
+    // a switching path starts at a post in a tree which is not an f-post
+    std::vector<IndexListType> comp_starts(comp_sink.size());
+    for (IndexType p = 0; p < num_posts(); ++p) {
+        if (comp_sink[comp[p]] != NONE and out_[p] != NONE and not is_f_post_[p]) {
+            comp_starts[comp[p]].emplace_back(p);
+        }
+    }
+
+    for (IndexType c = 0; c < comp_sink.size(); ++c) {
+        if (comp_sink[c] != NONE and not comp_starts[c].empty()) {
+            sinks_.emplace_back(comp_sink[c]);
+            starts_.emplace_back(std::move(comp_starts[c]));
+        }
+    }
+}
+
+SwitchingGraph::~SwitchingGraph()
+{}
+
+bool SwitchingGraph::is_applicable(const BipartiteGraph& G) {
+    auto unit_quotas = [] (const BipartiteGraph::ContainerType& vertices) {
+        for (const auto& it : vertices) {
+            if (it.second->get_upper_quota() != 1) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    if (not unit_quotas(G.get_A_partition()) or not unit_quotas(G.get_B_partition())) {
+        return false;
+    }
+
+    // no two posts share a rank on the list of an applicant
+    for (const auto& it : G.get_A_partition()) {
+        auto& pref_list = it.second->get_preference_list();
+        RankType prev_rank = 0;
+
+        for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+            auto rank = pref_list.get_rank(*i);
+
+            if (i != pref_list.all_begin() and rank == prev_rank) {
+                return false;
+            }
+
+            prev_rank = rank;
+        }
+    }
+
+    return true;
+}
+
+IndexType SwitchingGraph::num_posts() const {
+    return index_.num_B_vertices() + index_.num_A_vertices();
+}
+
+RankType SwitchingGraph::get_rank(IndexType a, IndexType p) const {
+    if (p >= index_.num_B_vertices()) {
+        return index_.A_end(a) - index_.A_begin(a) + 1;
+    }
+
+    return index_.get_A_rank(index_.find_edge(a, p));
+}
+
+VertexPtr SwitchingGraph::get_post(IndexType p) const {
+    const auto& B = index_.get_graph().get_B_vertices();
+    return p < B.size() ? B[p] : nullptr;
+}
+
+void SwitchingGraph::switch_from(IndexType p, IndexListType& mate) const {
+    auto u = p;
+
+    // move every applicant along the edge it owns until the walk comes
+    // back to p (a cycle) or reaches the sink (a path)
+    do {
+        mate[applicant_[u]] = out_[u];
+        u = out_[u];
+    } while (u != p and out_[u] != NONE);
+}
+
+MatchedPairListType SwitchingGraph::get_matching(const IndexListType& mate) const {
+    MatchedPairListType M;
+    const auto& A = index_.get_graph().get_A_vertices();
+
+    for (IndexType a = 0; a < mate.size(); ++a) {
+        auto b = get_post(mate[a]);
+
+        // applicants matched to their last resort posts are left unmatched
+        if (b) {
+            M[A[a]].add_partner(std::make_pair(get_rank(a, mate[a]), b));
+            M[b].add_partner(std::make_pair(1, A[a]));
+        }
+    }
+
+    return M;
+}
+
+IndexType SwitchingGraph::num_cycles() const {
+    return cycles_.size();
+}
+
+IndexType SwitchingGraph::num_paths() const {
+    return sinks_.size();
+}
+
+void SwitchingGraph::enumerate(const VisitorType& visit) const {
+    // the choice for every component: switch the cycle or not, and no path
+    // or the path from one of the starts of the tree
+    auto ncycles = cycles_.size();
+    IndexListType choice(ncycles + starts_.size(), 0);
+    IndexListType mate;
+
+    while (true) {
+        mate = mate_;
+
+        for (IndexType i = 0; i < ncycles; ++i) {
+            if (choice[i]) {
+                switch_from(cycles_[i], mate);
+            }
+        }
+
+        for (IndexType i = 0; i < starts_.size(); ++i) {
+            if (choice[ncycles + i]) {
+                switch_from(starts_[i][choice[ncycles + i] - 1], mate);
+            }
+        }
+
+        if (not visit(get_matching(mate))) {
+            return;
+        }
+
+        // the next combination of choices
+        IndexType i = 0;
+        for (; i < choice.size(); ++i) {
+            IndexType nchoices = i < ncycles ? 2 : starts_[i - ncycles].size() + 1;
+
+            if (++choice[i] < nchoices) {
+                break;
+            }
+
+            choice[i] = 0;
+        }
+
+        if (i == choice.size()) {
+            return;
+        }
+    }
+}
+
+MatchedPairListType SwitchingGraph::min_cost(const CostFunction& cost) const {
+    const auto& A = index_.get_graph().get_A_vertices();
+
+    // change in the cost when the applicant owning the edge leaving p is
+    // moved along it
+    auto gain = [&] (IndexType p) {
+        auto a = applicant_[p];
+        auto q = out_[p];
+        return cost(A[a], get_post(q), get_rank(a, q)) - cost(A[a], get_post(p), get_rank(a, p));
+    };
+
+    IndexListType mate = mate_;
+
+    // switch a cycle if it lowers the cost
+    for (auto p : cycles_) {
+        long total = 0;
+        auto u = p;
+
+        do {
+            total += gain(u);
+            u = out_[u];
+        } while (u != p);
+
+        if (total < 0) {
+            switch_from(p, mate);
+        }
+    }
+
+    // the gain of the path from every post of a tree to its sink, each post
+    // is looked at once
+    std::vector<long> to_sink(num_posts(), 0);
+    std::vector<char> known(num_posts(), false);
+    IndexListType path;
+
+    for (IndexType i = 0; i < sinks_.size(); ++i) {
+        IndexType best = NONE;
+        long best_total = 0;
+
+        for (auto p : starts_[i]) {
+            auto u = p;
+            path.clear();
+
+            while (out_[u] != NONE and not known[u]) {
+                path.emplace_back(u);
+                u = out_[u];
+            }
+
+            long total = to_sink[u];
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                total += gain(*it);
+                to_sink[*it] = total;
+                known[*it] = true;
+            }
+
+            if (to_sink[p] < best_total) {
+                best = p;
+                best_total = to_sink[p];
+            }
+        }
+
+        if (best != NONE) {
+            switch_from(best, mate);
+        }
+    }
+
+    return get_matching(mate);
+}
+
+MatchedPairListType SwitchingGraph::max_cardinality() const {
+    return min_cost([] (const VertexPtr& a, const VertexPtr& b, RankType rank) {
+        return b ? 0l : 1l;
+    });
+}
+
+MatchedPairListType SwitchingGraph::min_rank_sum() const {
+    return min_cost([] (const VertexPtr& a, const VertexPtr& b, RankType rank) {
+        return (long) rank;
+    });
+}
@@ -0,0 +1,193 @@
+#include "UnitMatching.h"
+#include <limits>
+
+const IndexType UnitMatching::NONE = std::numeric_limits<IndexType>::max();
+
+UnitMatching::UnitMatching(IndexType num_applicants, IndexType num_posts)
+    : A_mate_(num_applicants, NONE), A_edge_(num_applicants, NONE),
+      B_mate_(num_posts, NONE), decomposed_(false),
+      dist_(num_applicants), arc_(num_applicants)
+{
+    queue_.reserve(num_applicants);
+}
+
+UnitMatching::~UnitMatching()
+{}
+
+IndexType UnitMatching::build_layers(const Adjacency& G) {
+    IndexType nA = A_mate_.size();
+    IndexType last_layer = NONE;
+    queue_.clear();
+
+    for (IndexType a = 0; a < nA; ++a) {
+        dist_[a] = NONE;
+
+        if (A_mate_[a] == NONE) {
+            dist_[a] = 0;
+            queue_.emplace_back(a);
+        }
+    }
+
+    for (IndexType i = 0; i < queue_.size(); ++i) {
+        auto a = queue_[i];
+
+        // the shortest augmenting paths end in the layer of the first free
+        // post, the layers beyond it are not needed
+        if (last_layer != NONE and dist_[a] >= last_layer) {
+            break;
+        }
+
+        for (auto k = G.offsets[a]; k < G.offsets[a+1]; ++k) {
+            auto u = B_mate_[G.heads[k]];
+
+            if (u == NONE) {
+                last_layer = dist_[a];
+            } else if (dist_[u] == NONE) {
+                dist_[u] = dist_[a] + 1;
+                queue_.emplace_back(u);
+            }
+        }
+    }
+
+    return last_layer;
+}
+
+bool UnitMatching::augment(const Adjacency& G, IndexType root, IndexType last_layer) {
+    stack_.clear();
+    stack_.emplace_back(root);
+
+    while (not stack_.empty()) {
+        auto a = stack_.back();
+
+        if (arc_[a] == G.offsets[a+1]) {
+            // a is a dead end in this phase
+            dist_[a] = NONE;
+            stack_.pop_back();
+
+            if (not stack_.empty()) {
+                ++arc_[stack_.back()];
+            }
+
+            continue;
+        }
+
+        auto u = B_mate_[G.heads[arc_[a]]];
+
+        if (u == NONE) {
+            // every vertex on the stack takes the post it points to
+            for (auto v : stack_) {
+                auto p = G.heads[arc_[v]];
+                A_mate_[v] = p;
+                A_edge_[v] = G.edges[arc_[v]];
+                B_mate_[p] = v;
+            }
+
+            return true;
+        } else if (dist_[u] != NONE and dist_[u] == dist_[a] + 1 and dist_[u] <= last_layer) {
+            stack_.emplace_back(u);
+        } else {
+            ++arc_[a];
+        }
+    }
+
+    return false;
+}
+
+void UnitMatching::maximum_matching(const Adjacency& G, IndexType num_posts) {
+    IndexType nA = A_mate_.size();
+    B_mate_.resize(num_posts, NONE);
+
+    for (auto last_layer = build_layers(G); last_layer != NONE; last_layer = build_layers(G)) {
+        for (IndexType a = 0; a < nA; ++a) {
+            arc_[a] = G.offsets[a];
+        }
+
+        for (IndexType a = 0; a < nA; ++a) {
+            if (A_mate_[a] == NONE and dist_[a] == 0) {
+                augment(G, a, last_layer);
+            }
+        }
+    }
+}
+
+void UnitMatching::decompose(const Adjacency& G) {
+    IndexType nA = A_mate_.size();
+    IndexType nB = B_mate_.size();
+
+    // the arcs of the posts
+    B_offsets_.assign(nB + 1, 0);
+    for (auto b : G.heads) {
+        ++B_offsets_[b + 1];
+    }
+
+    for (IndexType b = 0; b < nB; ++b) {
+        B_offsets_[b+1] += B_offsets_[b];
+    }
+
+    queue_.assign(B_offsets_.begin(), B_offsets_.end() - 1);
+    B_heads_.resize(G.heads.size());
+    for (IndexType a = 0; a < nA; ++a) {
+        for (auto k = G.offsets[a]; k < G.offsets[a+1]; ++k) {
+            B_heads_[queue_[G.heads[k]]++] = a;
+        }
+    }
+
+    A_labels_.assign(nA, UNREACHABLE);
+    B_labels_.assign(nB, UNREACHABLE);
+    decomposed_ = true;
+
+    // alternating paths from the free applicants reach even applicants and
+    // odd posts
+    queue_.clear();
+    for (IndexType a = 0; a < nA; ++a) {
+        if (A_mate_[a] == NONE) {
+            A_labels_[a] = EVEN;
+            queue_.emplace_back(a);
+        }
+    }
+
+    for (IndexType i = 0; i < queue_.size(); ++i) {
+        auto a = queue_[i];
+
+        for (auto k = G.offsets[a]; k < G.offsets[a+1]; ++k) {
+            auto b = G.heads[k];
+
+            if (B_labels_[b] == UNREACHABLE) {
+                B_labels_[b] = ODD;
+                auto u = B_mate_[b];
+
+                if (u != NONE and A_labels_[u] == UNREACHABLE) {
+                    A_labels_[u] = EVEN;
+                    queue_.emplace_back(u);
+                }
+            }
+        }
+    }
+
+    // and those from the free posts reach even posts and odd applicants
+    queue_.clear();
+    for (IndexType b = 0; b < nB; ++b) {
+        if (B_mate_[b] == NONE) {
+            B_labels_[b] = EVEN;
+            queue_.emplace_back(b);
+        }
+    }
+
+    for (IndexType i = 0; i < queue_.size(); ++i) {
+        auto b = queue_[i];
+
+        for (auto k = B_offsets_[b]; k < B_offsets_[b+1]; ++k) {
+            auto a = B_heads_[k];
+
+            if (A_labels_[a] == UNREACHABLE) {
+                A_labels_[a] = ODD;
+                auto p = A_mate_[a];
+
+                if (p != NONE and B_labels_[p] == UNREACHABLE) {
+                    B_labels_[p] = EVEN;
+                    queue_.emplace_back(p);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#include "UnitPopular.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include "PopularityWitness.h"
+
+namespace {
+
+const IndexType NONE = UnitMatching::NONE;
+
+}
+
+UnitPopular::UnitPopular(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing)
+    : MatchingAlgorithm(G), index_(*G),
+      matching_(index_.num_A_vertices(), index_.num_B_vertices())
+{}
+
+UnitPopular::~UnitPopular()
+{}
+
+bool UnitPopular::is_applicable(const BipartiteGraph& G) {
+    auto unit_quotas = [] (const BipartiteGraph::ContainerType& vertices) {
+        for (const auto& it : vertices) {
+            if (it.second->get_upper_quota() != 1) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    return unit_quotas(G.get_A_partition()) and unit_quotas(G.get_B_partition());
+}
+
+bool UnitPopular::compute_matching() {
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+
+    // the rank-1 graph G1
+    UnitMatching::Adjacency G1;
+
+    for (IndexType a = 0; a < nA; ++a) {
+        auto begin = index_.A_begin(a), end = index_.A_end(a);
+
+        for (auto e = begin; e < end and index_.get_A_rank(e) == index_.get_A_rank(begin); ++e) {
+            G1.add_arc(index_.get_head(e), e);
+        }
+
+        G1.end_applicant();
+    }
+
+    // a maximum matching in G1 and the Gallai-Edmonds decomposition
+    matching_ = UnitMatching(nA, nB);
+    matching_.maximum_matching(G1, nB);
+    matching_.decompose(G1);
+
+    // the graph G' with the edges to f(a) and s(a) for every applicant a,
+    // without the edges between an odd vertex and an odd or unreachable
+    // vertex, the last resort post of a is the post nB + a
+    UnitMatching::Adjacency G2;
+
+    for (IndexType a = 0; a < nA; ++a) {
+        auto begin = index_.A_begin(a), end = index_.A_end(a);
+
+        if (begin == end) {
+            // a is matched to its last resort post in every popular matching
+            G2.end_applicant();
+            continue;
+        }
+
+        auto a_label = matching_.get_A_label(a);
+        auto f_rank = index_.get_A_rank(begin);
+        auto s_rank = f_rank;
+        bool has_s_post = false;
+
+        for (auto e = begin; e < end; ++e) {
+            auto b = index_.get_head(e);
+            auto b_label = matching_.get_B_label(b);
+            auto rank = index_.get_A_rank(e);
+
+            if (rank == f_rank) {
+                bool odd_edge = (a_label == UnitMatching::ODD and b_label != UnitMatching::EVEN) or
+                                (b_label == UnitMatching::ODD and a_label != UnitMatching::EVEN);
+
+                if (not odd_edge) {
+                    G2.add_arc(b, e);
+                }
+            }
+
+            // s(a) are the most preferred even posts of a
+            if (b_label == UnitMatching::EVEN and (not has_s_post or rank == s_rank)) {
+                has_s_post = true;
+                s_rank = rank;
+
+                if (rank != f_rank) {
+                    G2.add_arc(b, e);
+                }
+            }
+        }
+
+        if (not has_s_post) {
+            G2.add_arc(nB + a, NONE);
+        }
+
+        G2.end_applicant();
+    }
+
+    // augment the matching of G1 to a maximum matching in G'
+    matching_.maximum_matching(G2, nB + nA);
+
+    // popular matching exists iff the matching is applicant complete
+    for (IndexType a = 0; a < nA; ++a) {
+        if (index_.A_begin(a) != index_.A_end(a) and matching_.get_A_mate(a) == NONE) {
+            return false;
+        }
+    }
+
+    const auto& A = get_graph()->get_A_vertices();
+    const auto& B = get_graph()->get_B_vertices();
+
+    for (IndexType a = 0; a < nA; ++a) {
+        auto e = matching_.get_A_edge(a);
+
+        // applicants matched to their last resort posts are left unmatched
+        if (e != NONE) {
+            const auto& post = B[index_.get_head(e)];
+            M_[A[a]].add_partner(std::make_pair(index_.get_A_rank(e), post));
+            M_[post].add_partner(std::make_pair(1, A[a]));
+        }
+    }
+
+    return true;
+}
+
+bool UnitPopular::get_witness(PopularityWitness& witness) {
+    if (not matching_.is_decomposed()) {
+        return false;
+    }
+
+    const auto& A = get_graph()->get_A_vertices();
+    const auto& B = get_graph()->get_B_vertices();
+
+    for (IndexType b = 0; b < index_.num_B_vertices(); ++b) {
+        // even posts have alpha 0
+        if (matching_.get_B_label(b) == UnitMatching::EVEN) {
+            continue;
+        }
+
+        witness.set_free_alpha(B[b], 1);
+
+        auto a = matching_.get_B_mate(b);
+        if (a != NONE) {
+            witness.set_alpha(B[b], A[a], 1);
+
+            // is the applicant matched through a rank 1 edge
+            auto e = matching_.get_A_edge(a);
+            if (index_.get_A_rank(e) == index_.get_A_rank(index_.A_begin(a))) {
+                witness.set_alpha(A[a], B[b], -1);
+            }
+        }
+    }
+
+    return true;
+}
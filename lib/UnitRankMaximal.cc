@@ -0,0 +1,99 @@
+#include "UnitRankMaximal.h"
+#include "UnitPopular.h"
+#include "Vertex.h"
+#include "PartnerList.h"
+#include <algorithm>
+
+namespace {
+
+const IndexType NONE = UnitMatching::NONE;
+
+}
+
+UnitRankMaximal::UnitRankMaximal(const std::unique_ptr<BipartiteGraph>& G, bool A_proposing)
+    : MatchingAlgorithm(G), index_(*G),
+      matching_(index_.num_A_vertices(), index_.num_B_vertices())
+{}
+
+UnitRankMaximal::~UnitRankMaximal()
+{}
+
+bool UnitRankMaximal::is_applicable(const BipartiteGraph& G) {
+    return UnitPopular::is_applicable(G);
+}
+
+void UnitRankMaximal::delete_edges(RankType rank) {
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        auto a_label = matching_.get_A_label(index_.get_tail(e));
+        auto b_label = matching_.get_B_label(index_.get_head(e));
+
+        if (index_.get_A_rank(e) > rank) {
+            // odd and unreachable vertices are matched in every maximum
+            // matching of the current graph, so by edges of rank at most rank
+            if (a_label != UnitMatching::EVEN or b_label != UnitMatching::EVEN) {
+                deleted_[e] = true;
+            }
+        } else if ((a_label == UnitMatching::ODD and b_label != UnitMatching::EVEN) or
+                   (b_label == UnitMatching::ODD and a_label != UnitMatching::EVEN)) {
+            // odd-odd and odd-unreachable edges are in no maximum matching
+            deleted_[e] = true;
+        }
+    }
+}
+
+bool UnitRankMaximal::compute_matching() {
+    IndexType nA = index_.num_A_vertices();
+    IndexType nB = index_.num_B_vertices();
+
+    RankType max_rank = 0;
+    for (IndexType e = 0; e < index_.num_edges(); ++e) {
+        max_rank = std::max(max_rank, index_.get_A_rank(e));
+    }
+
+    matching_ = UnitMatching(nA, nB);
+    deleted_.assign(index_.num_edges(), false);
+
+    UnitMatching::Adjacency G;
+
+    for (RankType rank = 1; rank <= max_rank; ++rank) {
+        // the graph G'_rank, with the edges of rank at most rank which have
+        // not been deleted
+        G.clear();
+
+        for (IndexType a = 0; a < nA; ++a) {
+            for (auto e = index_.A_begin(a); e < index_.A_end(a); ++e) {
+                if (index_.get_A_rank(e) <= rank and not deleted_[e]) {
+                    G.add_arc(index_.get_head(e), e);
+                }
+            }
+
+            G.end_applicant();
+        }
+
+        // augment the matching of the previous phase, which is a matching
+        // of this graph as matched edges are never deleted
+        matching_.maximum_matching(G, nB);
+
+        if (rank == max_rank) {
+            break;
+        }
+
+        matching_.decompose(G);
+        delete_edges(rank);
+    }
+
+    const auto& A = get_graph()->get_A_vertices();
+    const auto& B = get_graph()->get_B_vertices();
+
+    for (IndexType a = 0; a < nA; ++a) {
+        auto e = matching_.get_A_edge(a);
+
+        if (e != NONE) {
+            const auto& post = B[index_.get_head(e)];
+            M_[A[a]].add_partner(std::make_pair(index_.get_A_rank(e), post));
+            M_[post].add_partner(std::make_pair(1, A[a]));
+        }
+    }
+
+    return true;
+}
@@ -3,6 +3,7 @@
 #include "PartnerList.h"
 #include <set>
 #include <sstream>
+#include <stdexcept>
 
 // a new id is of the form id^k
 IdType get_vertex_id(const IdType& id, int k) {
@@ -30,7 +31,7 @@ int get_dummy_level(const IdType& id) {
 }
 
 void print_matching(const std::unique_ptr<BipartiteGraph>& G,
-                    MatchedPairListType& M, std::ostream& out)
+                    const MatchedPairListType& M, std::ostream& out)
 {
     std::stringstream stmp;
     std::set<VertexPtr> printed;
@@ -75,3 +76,46 @@ void print_matching(const std::unique_ptr<BipartiteGraph>& G,
 
     out << stmp.str();
 }
+
+MatchedPairListType read_matching(const std::unique_ptr<BipartiteGraph>& G,
+                                  std::istream& in)
+{
+    MatchedPairListType M;
+    const auto& A = G->get_A_partition();
+    const auto& B = G->get_B_partition();
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        // a,b,rank
+        std::stringstream stmp(line);
+        std::string a_id, b_id, rank;
+        std::getline(stmp, a_id, ',');
+        std::getline(stmp, b_id, ',');
+        std::getline(stmp, rank);
+
+        auto a = A.find(a_id);
+        auto b = B.find(b_id);
+        if (a == A.end() or b == B.end()) {
+            throw std::runtime_error("invalid matched pair " + line);
+        }
+
+        // rank of a on the list of b, 1 if b does not rank its partners
+        RankType b_rank = 1;
+        auto& pref_list = b->second->get_preference_list();
+        for (auto i = pref_list.all_begin(), e = pref_list.all_end(); i != e; ++i) {
+            if (pref_list.get_vertex(*i) == a->second) {
+                b_rank = pref_list.get_rank(*i);
+                break;
+            }
+        }
+
+        M[a->second].add_partner(std::make_pair(std::atoi(rank.c_str()), b->second));
+        M[b->second].add_partner(std::make_pair(b_rank, a->second));
+    }
+
+    return M;
+}
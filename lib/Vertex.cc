@@ -1,4 +1,5 @@
 #include "Vertex.h"
+#include <limits>
 #include <sstream>
 
 Vertex::Vertex(const IdType& id)
@@ -20,8 +21,9 @@ Vertex::Vertex(const IdType& id, unsigned lower_quota, unsigned upper_quota, boo
 Vertex::Vertex(const IdType& id, const IdType& cloned_for_id,
                unsigned lower_quota, unsigned upper_quota, bool dummy)
     : id_(id), cloned_for_id_(cloned_for_id),
+      index_(std::numeric_limits<IndexType>::max()), graph_(nullptr),
       lower_quota_(lower_quota), upper_quota_(upper_quota),
-      dummy_(dummy)
+      dummy_(dummy), level_(0)
 {}
 
 Vertex::~Vertex()
@@ -47,6 +49,46 @@ bool Vertex::is_dummy() const {
     return dummy_;
 }
 
+IndexType Vertex::get_index() const {
+    return index_;
+}
+
+const BipartiteGraph* Vertex::get_graph() const {
+    return graph_;
+}
+
+void Vertex::set_index(const BipartiteGraph* graph, IndexType index) {
+    graph_ = graph;
+    index_ = index;
+}
+
+void Vertex::set_origin(const VertexPtr& origin, int level) {
+    origin_ = origin;
+    level_ = level;
+}
+
+const VertexPtr& Vertex::get_origin() const {
+    return origin_;
+}
+
+int Vertex::get_level() const {
+    return level_;
+}
+
+void Vertex::emplace_back_with_origin(VertexPtr v, RankType origin_rank) {
+    pref_list_.emplace_back(v);
+    origin_ranks_.emplace_back(origin_rank);
+}
+
+RankType Vertex::get_origin_rank(RankType rank) const {
+    // the reduced lists are strict, hence rank r is at position r-1
+    if (rank < 1 or (std::size_t) rank > origin_ranks_.size()) {
+        return 0;
+    }
+
+    return origin_ranks_[rank - 1];
+}
+
 PreferenceList& Vertex::get_preference_list() {
     return pref_list_;
 }
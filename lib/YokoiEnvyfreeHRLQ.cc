@@ -5,6 +5,8 @@
 #include "PartnerList.h"
 #include "TDefs.h"
 #include "Utils.h"
+#include "SReduction.h"
+#include "ReducedGraphCache.h"
 #include <stack>
 #include <algorithm>
 #include <cassert>
@@ -21,7 +23,12 @@ MatchedPairListType& YokoiEnvyfreeHRLQ::get_matched_pairs() {
 }
 
 bool YokoiEnvyfreeHRLQ::compute_matching() {
-    const std::unique_ptr<BipartiteGraph>& G1 = augment_graph();
+    // the graph restricted to the lower quota hospitals, shared with the
+    // other algorithms through the cache of G
+    const std::unique_ptr<BipartiteGraph>& G = get_graph();
+    auto G1_ptr = G->get_reduced_graphs().get("lower-quota", 0,
+                        [&G] { return augment_lower_quota_graph(G); });
+    const std::unique_ptr<BipartiteGraph>& G1 = *G1_ptr;
 
     // find a resident proposing stable matching
     StableMarriage sm(G1);
@@ -56,64 +63,3 @@ bool YokoiEnvyfreeHRLQ::compute_matching() {
 
     return false;
 }
-
-std::unique_ptr<BipartiteGraph> YokoiEnvyfreeHRLQ::augment_graph() {
-    BipartiteGraph::ContainerType A, B;
-    const std::unique_ptr<BipartiteGraph>& G = get_graph();
-
-    // add all vertices from partition B / hospitals
-    for (auto it : G->get_B_partition()) {
-        auto v = it.second;
-
-        // only keep vertices in B with > 0 lower quota
-        if (v->get_lower_quota() > 0) {
-            // create a new vertex with quota (0, l_h)
-            auto u_id = v->get_id();
-            auto u = std::make_shared<Vertex>(u_id, 0, v->get_lower_quota());
-
-            // add this vertex to partition B
-            B.emplace(u_id, u);
-
-            // preference list of this vertex is same as in G
-            auto& v_pref_list = v->get_preference_list();
-            auto& u_pref_list = u->get_preference_list();
-
-            // copy the preference list as it is
-            for (auto i = v_pref_list.all_begin(), e = v_pref_list.all_end();
-                    i != e; ++i)
-            {
-                auto r_old = v_pref_list.get_vertex(*i);
-                auto r_id = r_old->get_id();
-                auto r = std::make_shared<Vertex>(r_id,
-                            r_old->get_lower_quota(), r_old->get_upper_quota());
-
-                // add the neighbouring vertex to A as well
-                A.emplace(r_id, r);
-                u_pref_list.emplace_back(r);
-            }
-        }
-    }
-
-    // settle preferences for the residents in the new graph
-    auto& A_old = G->get_A_partition();
-
-    for (auto it : A) {
-        auto r = it.second;
-        auto r_old = A_old.at(r->get_id());
-        auto& r_pref_list = r->get_preference_list();
-        auto& old_pref_list = r_old->get_preference_list();
-
-        for (auto i = old_pref_list.all_begin(), e = old_pref_list.all_end();
-             i != e; ++i)
-        {
-            auto h_old = old_pref_list.get_vertex(*i);
-
-            // add this vertex to pref list only if it has a positive lower quota
-            if (h_old->get_lower_quota() > 0) {
-                r_pref_list.emplace_back(B.at(h_old->get_id()));
-            }
-        }
-    }
-
-    return std::make_unique<BipartiteGraph>(A, B);
-}
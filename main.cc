@@ -1,6 +1,7 @@
 #include "GraphReader.h"
 #include "BipartiteGraph.h"
 #include "PartnerList.h"
+#include "Vertex.h"
 #include "MatchingAlgorithm.h"
 #include "StableMarriage.h"
 #include "RelaxedStable.h"
@@ -11,25 +12,311 @@
 #include "MaximalEnvyfreeHRLQ.h"
 #include "ClassifiedPopular.h"
 #include "ClassifiedRankMaximal.h"
+#include "MaxCardinality.h"
+#include "MinRankSum.h"
+#include "LowerQuotaFeasibility.h"
+#include "UnitPopular.h"
+#include "UnitRankMaximal.h"
+#include "SwitchingGraph.h"
+#include "DynamicPopular.h"
+#include "FlowNetwork.h"
+#include "MatchingComparison.h"
+#include "ReducedGraphCache.h"
+#include "Statistics.h"
+#include "MetricsWriter.h"
 #include "Utils.h"
+#include <sstream>
 #include <stdexcept>
 #include <iostream>
 #include <unistd.h>
 
 template<typename T>
-void compute_matching(bool A_proposing, const char* input_file, const char* output_file) {
-    GraphReader reader(input_file);
-    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
-
+void compute_matching(bool A_proposing, const std::unique_ptr<BipartiteGraph>& G,
+                      const char* output_file, const char* witness_file, bool verbose,
+                      MetricsWriter* metrics = nullptr) {
     T alg(G, A_proposing);
     if (alg.compute_matching()) {
         auto& M = alg.get_matched_pairs();
         std::ofstream out(output_file);
         print_matching(G, M, out);
+
+        if (metrics) {
+            Statistics statistics(*G);
+            metrics->write(statistics.get_statistics(M));
+        }
+
+        if (witness_file) {
+            PopularityWitness witness;
+
+            if (alg.get_witness(witness)) {
+                std::ofstream witness_out(witness_file);
+                witness.write(G, witness_out);
+            } else {
+                std::cerr << "No popularity witness available\n";
+            }
+        }
     }
     else {
         std::cout << "No popular matching\n";
     }
+
+    if (verbose) {
+        alg.write_statistics(std::cerr);
+
+        // only the algorithms which reduce the graph look it up in the cache
+        const auto& cache_stats = G->get_reduced_graphs().get_statistics();
+        if (cache_stats.hits + cache_stats.misses > 0) {
+            std::cerr << cache_stats;
+        }
+    }
+}
+
+template<typename T>
+void compute_matching(bool A_proposing, const char* input_file, const char* output_file,
+                      const char* witness_file = nullptr, bool verbose = false,
+                      MetricsWriter* metrics = nullptr) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+    compute_matching<T>(A_proposing, G, output_file, witness_file, verbose, metrics);
+}
+
+/// popular matching in a many-to-many instance with one-sided preferences,
+/// instances where every quota is one use the faster UnitPopular
+void compute_popular_matching(bool A_proposing, const char* input_file, const char* output_file,
+                              const char* witness_file, bool verbose, MetricsWriter* metrics) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+
+    if (UnitPopular::is_applicable(*G)) {
+        compute_matching<UnitPopular>(A_proposing, G, output_file, witness_file, verbose, metrics);
+    } else {
+        compute_matching<ClassifiedPopular>(A_proposing, G, output_file, witness_file, verbose, metrics);
+    }
+}
+
+/// rank-maximal matching in a many-to-many instance, instances where every
+/// quota is one use the faster UnitRankMaximal
+void compute_rank_maximal_matching(bool A_proposing, const char* input_file,
+                                   const char* output_file, bool verbose, MetricsWriter* metrics) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+
+    if (UnitRankMaximal::is_applicable(*G)) {
+        compute_matching<UnitRankMaximal>(A_proposing, G, output_file, nullptr, verbose, metrics);
+    } else {
+        compute_matching<ClassifiedRankMaximal>(A_proposing, G, output_file, nullptr, verbose, metrics);
+    }
+}
+
+/// matching in an HRLQ instance, if no matching meets the lower quotas the
+/// algorithm is not run and a deficient set of vertices in B is printed
+template<typename T>
+void compute_hrlq_matching(bool A_proposing, const char* input_file, const char* output_file,
+                           bool verbose, MetricsWriter* metrics) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+    LowerQuotaFeasibility feasibility(*G);
+
+    if (not feasibility.is_feasible()) {
+        std::cout << "No matching meets the lower quotas, deficient set:";
+        for (const auto& v : feasibility.get_deficient_set()) {
+            std::cout << ' ' << v->get_id();
+        }
+        std::cout << " (short by " << feasibility.get_deficiency() << ")\n";
+        return;
+    }
+
+    compute_matching<T>(A_proposing, G, output_file, nullptr, verbose, metrics);
+}
+
+/// popular matchings found from the switching graph of the matching of
+/// UnitPopular, objective is one of max_card, min_rank or all, a row of
+/// metrics is written for every matching
+void compute_switching_matchings(const char* input_file, const char* output_file,
+                                 const std::string& objective, bool verbose,
+                                 MetricsWriter* metrics) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+
+    if (objective != "max_card" and objective != "min_rank" and objective != "all") {
+        std::cerr << "Unknown objective: " << objective << '\n';
+        return;
+    } else if (not SwitchingGraph::is_applicable(*G)) {
+        std::cerr << "Option -O requires strict preferences and quotas of one.\n";
+        return;
+    }
+
+    UnitPopular alg(G);
+    if (not alg.compute_matching()) {
+        std::cout << "No popular matching\n";
+        return;
+    }
+
+    SwitchingGraph switching_graph(*G, alg.get_matched_pairs());
+    std::ofstream out(output_file);
+
+    // the deficiency of the graph is only computed once for all the rows
+    std::unique_ptr<Statistics> statistics;
+    if (metrics) {
+        statistics.reset(new Statistics(*G));
+    }
+
+    auto write_matching = [&] (const MatchedPairListType& M) {
+        print_matching(G, M, out);
+
+        if (statistics) {
+            metrics->write(statistics->get_statistics(M));
+        }
+    };
+
+    if (objective == "all") {
+        // the matchings are separated by an empty line
+        switching_graph.enumerate([&] (const MatchedPairListType& M) {
+            write_matching(M);
+            out << '\n';
+            return true;
+        });
+    } else if (objective == "max_card") {
+        write_matching(switching_graph.max_cardinality());
+    } else {
+        write_matching(switching_graph.min_rank_sum());
+    }
+
+    if (verbose) {
+        std::cerr << "switching_graph_cycles," << switching_graph.num_cycles() << '\n'
+                  << "switching_graph_paths," << switching_graph.num_paths() << '\n';
+    }
+}
+
+/// apply the edits in edits_file to the popular matching of the graph one
+/// at a time, an edit is a line "a:b1,b2,..." which replaces the list of a
+/// (adding a if needed) or "-a" which removes a, whether a popular matching
+/// exists is printed after every edit and the final matching is written
+void compute_dynamic_matching(const char* input_file, const char* edits_file,
+                              const char* output_file, bool verbose) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+
+    if (not DynamicPopular::is_applicable(*G)) {
+        std::cerr << "Option -d requires strict preferences and quotas of one.\n";
+        return;
+    }
+
+    DynamicPopular dynamic(*G);
+    std::ifstream in(edits_file);
+    std::string line;
+    unsigned nedits = 0;
+
+    while (std::getline(in, line)) {
+        // ignore whitespace, empty lines and comments
+        std::string edit;
+        for (auto ch : line) {
+            if (not isspace(ch)) {
+                edit.push_back(ch);
+            }
+        }
+
+        if (edit.empty() or edit[0] == '#') {
+            continue;
+        }
+
+        bool exists = false;
+        if (edit[0] == '-') {
+            exists = dynamic.remove_applicant(edit.substr(1));
+        } else {
+            auto colon_pos = edit.find(':');
+            if (colon_pos == std::string::npos) {
+                throw std::runtime_error("invalid edit " + line);
+            }
+
+            std::vector<IdType> pref_list;
+            std::stringstream stmp(edit.substr(colon_pos + 1));
+            std::string b;
+            while (std::getline(stmp, b, ',')) {
+                if (not b.empty()) {
+                    pref_list.emplace_back(b);
+                }
+            }
+
+            exists = dynamic.set_preferences(edit.substr(0, colon_pos), pref_list);
+        }
+
+        std::cout << "edit_" << ++nedits << ',' << (exists ? "popular" : "none") << '\n';
+    }
+
+    if (dynamic.has_popular_matching()) {
+        std::ofstream out(output_file);
+        dynamic.write_matching(out);
+    } else {
+        std::cout << "No popular matching\n";
+    }
+
+    if (verbose) {
+        std::cerr << dynamic.get_statistics();
+    }
+}
+
+void print_unpopularity_factor(const MatchingComparison& comparison, const char* name,
+                               const MatchedPairListType& M, std::ostream& out) {
+    try {
+        auto factor = comparison.unpopularity_factor(M);
+        out << "unpopularity_factor_" << name << ',';
+
+        if (factor.is_unbounded()) {
+            out << "inf\n";
+        } else {
+            out << factor.num << '/' << factor.den << '\n';
+        }
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "Cannot compute the unpopularity factor: " << e.what() << '\n';
+    }
+}
+
+void compare_matchings(const char* input_file, const char* first_file,
+                       const char* second_file, const char* output_file, bool one_sided) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+    MatchingComparison comparison(*G, one_sided);
+
+    std::ifstream first_in(first_file);
+    auto M1 = read_matching(G, first_in);
+    std::ofstream out(output_file);
+
+    if (second_file) {
+        std::ifstream second_in(second_file);
+        auto M2 = read_matching(G, second_in);
+        auto votes = comparison.compare(M1, M2);
+
+        out << "votes_first," << votes.first << '\n'
+            << "votes_second," << votes.second << '\n'
+            << "margin," << votes.margin() << '\n';
+        print_unpopularity_factor(comparison, "first", M1, out);
+        print_unpopularity_factor(comparison, "second", M2, out);
+    } else {
+        print_unpopularity_factor(comparison, "first", M1, out);
+    }
+}
+
+void verify_witness(const char* input_file, const char* matching_file,
+                    const char* witness_file, const char* output_file, bool one_sided) {
+    GraphReader reader(input_file);
+    std::unique_ptr<BipartiteGraph> G = reader.read_graph();
+    MatchingComparison comparison(*G, one_sided);
+
+    std::ifstream matching_in(matching_file);
+    auto M = read_matching(G, matching_in);
+    std::ifstream witness_in(witness_file);
+    PopularityWitness witness;
+    witness.read(G, witness_in);
+
+    std::string error;
+    std::ofstream out(output_file);
+    if (comparison.verify_witness(M, witness, error)) {
+        out << "witness,valid\n";
+    } else {
+        out << "witness,invalid," << error << '\n';
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -44,19 +331,58 @@ int main(int argc, char* argv[]) {
     bool compute_ehrlq = false;
     bool compute_cpm = false;
     bool compute_crmm = false;
+    bool compute_mcm = false;
+    bool compute_min_rank = false;
+    bool compare = false;
+    bool verify = false;
+    bool verbose = false;
     bool A_proposing = true;
     const char* input_file = nullptr;
     const char* output_file = nullptr;
+    const char* first_file = nullptr;
+    const char* second_file = nullptr;
+    const char* witness_file = nullptr;
+    const char* objective = nullptr;
+    const char* edits_file = nullptr;
+    const char* metrics_file = nullptr;
 
     opterr = 0;
     // choose the proposing partition using -A and -B
     // -s, -p, and -m flags compute the stable, max-card popular and pop among
     // max-card matchings respectively
     // -r and -h compute the resident and hopsital heuristic for an HRLQ instance
-    // -c computes the many-to-one popular matching
+    // (-r, -h, -y and -e first check with a maximum flow that some matching
+    // meets the lower quotas, and print a deficient set of hospitals if not)
+    // -c computes the many-to-one popular matching (with UnitPopular if every
+    // quota is one)
+    // -l computes the many-to-many rank-maximal matching (with UnitRankMaximal
+    // if every quota is one)
+    // -O with -c finds the popular matching with the given objective (max_card
+    // or min_rank) or lists all of them (all) using the switching graph, when
+    // the preferences are strict and every quota is one
+    // -d with -c keeps the popular matching up to date while applying the edits
+    // to the preference lists in the given file (strict preferences and quotas
+    // of one)
+    // -F chooses the maximum flow algorithm of -c and -l (dinic, push_relabel
+    // or auto)
+    // -x computes a maximum cardinality matching
+    // -n computes a maximum cardinality matching with the least sum of ranks
+    // -v compares the matchings in the files given by -f and -g (optional)
+    // and writes the votes and unpopularity factors to the file given by -o
+    // -w writes a popularity witness for -p and -c to the given file
+    // -t checks that the witness given by -w certifies the matching given by -f
+    // (-v and -t with -c only count the votes of A, as the popularity of -c is
+    // one-sided)
+    // -V prints statistics about the computation (such as the use of the cache
+    // of reduced graphs, which only hits when the library runs several
+    // algorithms on one graph, never for a single run) to stderr
+    // -j appends the statistics of the matching computed (size, blocking pairs,
+    // rank profile, residents of every hospital...) to the given file, as JSON
+    // if its name ends in .json or .jsonl and as CSV otherwise (one row for
+    // every matching of -O, -j cannot be used with -v, -t and -d)
     // -i is the path to the input graph, -o is the path where the matching
     // computed should be stored
-    while ((c = getopt(argc, argv, "ABkspmrhyecli:o:")) != -1) {
+    while ((c = getopt(argc, argv, "ABkspmrhyeclxnvtVi:o:f:g:w:O:d:F:j:")) != -1) {
         switch (c) {
         case 'A': A_proposing = true; break;
         case 'B': A_proposing = false; break;
@@ -70,8 +396,30 @@ int main(int argc, char* argv[]) {
         case 'e': compute_ehrlq = true; break;
         case 'c': compute_cpm = true; break;
         case 'l': compute_crmm = true; break;
+        case 'x': compute_mcm = true; break;
+        case 'n': compute_min_rank = true; break;
+        case 'v': compare = true; break;
+        case 't': verify = true; break;
+        case 'V': verbose = true; break;
         case 'i': input_file = optarg; break;
         case 'o': output_file = optarg; break;
+        case 'f': first_file = optarg; break;
+        case 'g': second_file = optarg; break;
+        case 'w': witness_file = optarg; break;
+        case 'O': objective = optarg; break;
+        case 'd': edits_file = optarg; break;
+        case 'j': metrics_file = optarg; break;
+        case 'F':
+            if (std::string(optarg) == "dinic") {
+                FlowNetwork::set_default_algorithm(FlowNetwork::DINIC);
+            } else if (std::string(optarg) == "push_relabel") {
+                FlowNetwork::set_default_algorithm(FlowNetwork::PUSH_RELABEL);
+            } else if (std::string(optarg) == "auto") {
+                FlowNetwork::set_default_algorithm(FlowNetwork::AUTO);
+            } else {
+                std::cerr << "Unknown maximum flow algorithm: " << optarg << '\n';
+            }
+            break;
         case '?':
             if (optopt == 'i') {
                 std::cerr << "Option -i requires an argument.\n";
@@ -79,6 +427,10 @@ int main(int argc, char* argv[]) {
             else if (optopt == 'o') {
                 std::cerr << "Option -o requires an argument.\n";
             }
+            else if (optopt == 'f' or optopt == 'g' or optopt == 'w' or
+                     optopt == 'O' or optopt == 'd' or optopt == 'F' or optopt == 'j') {
+                std::cerr << "Option -" << (char)optopt << " requires an argument.\n";
+            }
             else {
                 std::cerr << "Unknown option: " << (char)optopt << '\n';
             }
@@ -87,38 +439,80 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (not input_file or not output_file) {
-        // do not proceed if file names are not valid
-    }
-    else if (compute_stable) {
-        compute_matching<StableMarriage>(A_proposing, input_file, output_file);
-    }
-    else if (compute_rsm) {
-        compute_matching<RelaxedStable>(A_proposing, input_file, output_file);
-    }
-    else if (compute_popular) {
-        compute_matching<MaxCardPopular>(A_proposing, input_file, output_file);
+    // -v and -t compute no matching, and the matching of -d is for edited
+    // preferences which the statistics of the input graph do not describe
+    if (metrics_file and (verify or compare or (compute_cpm and edits_file))) {
+        std::cerr << "Option -j cannot be used with -v, -t or -d.\n";
+        return 1;
     }
-    else if (compute_max_card) {
-        compute_matching<PopularAmongMaxCard>(A_proposing, input_file, output_file);
-    }
-    else if (compute_rhrlq) {
-        compute_matching<RHeuristicHRLQ>(A_proposing, input_file, output_file);
-    }
-    else if (compute_hhrlq) {
-        compute_matching<HHeuristicHRLQ>(A_proposing, input_file, output_file);
-    }
-    else if (compute_yhrlq) {
-        compute_matching<YokoiEnvyfreeHRLQ>(A_proposing, input_file, output_file);
-    }
-    else if (compute_ehrlq) {
-        compute_matching<MaximalEnvyfreeHRLQ>(A_proposing, input_file, output_file);
+
+    std::unique_ptr<MetricsWriter> metrics;
+    if (metrics_file and input_file) {
+        metrics.reset(new MetricsWriter(metrics_file));
+        metrics->set_instance(input_file);
     }
-    else if (compute_cpm) {
-        compute_matching<ClassifiedPopular>(A_proposing, input_file, output_file);
+
+    // malformed input files (graphs, matchings and witnesses) throw
+    try {
+        if (not input_file or not output_file) {
+            // do not proceed if file names are not valid
+        }
+        else if (verify) {
+            if (first_file and witness_file) {
+                verify_witness(input_file, first_file, witness_file, output_file, compute_cpm);
+            }
+        }
+        else if (compare) {
+            if (first_file) {
+                compare_matchings(input_file, first_file, second_file, output_file, compute_cpm);
+            }
+        }
+        else if (compute_stable) {
+            compute_matching<StableMarriage>(A_proposing, input_file, output_file, nullptr, verbose, metrics.get());
+        }
+        else if (compute_rsm) {
+            compute_matching<RelaxedStable>(A_proposing, input_file, output_file, nullptr, verbose, metrics.get());
+        }
+        else if (compute_popular) {
+            compute_matching<MaxCardPopular>(A_proposing, input_file, output_file, witness_file, verbose, metrics.get());
+        }
+        else if (compute_max_card) {
+            compute_matching<PopularAmongMaxCard>(A_proposing, input_file, output_file, nullptr, verbose, metrics.get());
+        }
+        else if (compute_rhrlq) {
+            compute_hrlq_matching<RHeuristicHRLQ>(A_proposing, input_file, output_file, verbose, metrics.get());
+        }
+        else if (compute_hhrlq) {
+            compute_hrlq_matching<HHeuristicHRLQ>(A_proposing, input_file, output_file, verbose, metrics.get());
+        }
+        else if (compute_yhrlq) {
+            compute_hrlq_matching<YokoiEnvyfreeHRLQ>(A_proposing, input_file, output_file, verbose, metrics.get());
+        }
+        else if (compute_ehrlq) {
+            compute_hrlq_matching<MaximalEnvyfreeHRLQ>(A_proposing, input_file, output_file, verbose, metrics.get());
+        }
+        else if (compute_cpm and edits_file) {
+            compute_dynamic_matching(input_file, edits_file, output_file, verbose);
+        }
+        else if (compute_cpm and objective) {
+            compute_switching_matchings(input_file, output_file, objective, verbose, metrics.get());
+        }
+        else if (compute_cpm) {
+            compute_popular_matching(A_proposing, input_file, output_file, witness_file, verbose, metrics.get());
+        }
+        else if (compute_crmm) {
+            compute_rank_maximal_matching(A_proposing, input_file, output_file, verbose, metrics.get());
+        }
+        else if (compute_mcm) {
+            compute_matching<MaxCardinality>(A_proposing, input_file, output_file, nullptr, verbose, metrics.get());
+        }
+        else if (compute_min_rank) {
+            compute_matching<MinRankSum>(A_proposing, input_file, output_file, nullptr, verbose, metrics.get());
+        }
     }
-    else if (compute_crmm) {
-        compute_matching<ClassifiedRankMaximal>(A_proposing, input_file, output_file);
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,30 @@
+# Compare the maximum flow algorithms (-F) on CPM (-c) and CRMM (-l)
+# usage: bench_maxflow.sh /path/to/graphmatching [graph files]
+# the graphs default to the instances in this directory, each run is
+# repeated REPEAT times (5 by default) and the total time is printed as
+# instance,algorithm,flow algorithm,seconds
+GMBIN=${1:?usage: bench_maxflow.sh /path/to/graphmatching [graph files]}
+shift
+REPEAT=${REPEAT:-5}
+DIRPATH=$(dirname "$0")
+OUTFILE=$(mktemp)
+
+if [ $# -eq 0 ]; then
+  set -- "$DIRPATH"/*.txt
+fi
+
+TIMEFORMAT=%R
+for GFILE in "$@"; do
+  for FLAG in -c -l; do
+    for ENGINE in dinic push_relabel auto; do
+      SECONDS_TAKEN=$( { time (
+        for i in $(seq "$REPEAT"); do
+          $GMBIN $FLAG -F $ENGINE -i "$GFILE" -o "$OUTFILE" > /dev/null
+        done
+      ) ; } 2>&1 )
+      echo "$(basename "$GFILE"),$FLAG,$ENGINE,$SECONDS_TAKEN"
+    done
+  done
+done
+
+rm -f "$OUTFILE"
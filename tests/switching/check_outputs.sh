@@ -0,0 +1,34 @@
+# Check the matchings of -c -O and -c -d against the expected outputs
+# usage: check_outputs.sh /path/to/graphmatching
+# every case compares what the command prints followed by the matching it
+# writes with the file <case>.expected of this directory, the result is
+# printed as case,result, the exit status is 1 if some output differs
+GMBIN=${1:?usage: check_outputs.sh /path/to/graphmatching}
+DIRPATH=$(dirname "$0")
+TMPDIR=$(mktemp -d)
+STATUS=0
+
+run_case() {
+  NAME=$1
+  shift
+  rm -f "$TMPDIR"/matching
+  $GMBIN "$@" -o "$TMPDIR"/matching > "$TMPDIR"/result 2>&1
+  cat "$TMPDIR"/matching >> "$TMPDIR"/result 2> /dev/null
+
+  if cmp -s "$TMPDIR"/result "$DIRPATH/$NAME.expected"; then
+    echo "$NAME,ok"
+  else
+    echo "$NAME,differs"
+    diff "$DIRPATH/$NAME.expected" "$TMPDIR"/result
+    STATUS=1
+  fi
+}
+
+for OBJECTIVE in all max_card min_rank; do
+  run_case cycle_tree_$OBJECTIVE -c -O $OBJECTIVE -i "$DIRPATH"/cycle_tree.txt
+done
+
+run_case edits -c -d "$DIRPATH"/edits.txt -i "$DIRPATH"/cycle_tree.txt
+
+rm -rf "$TMPDIR"
+exit $STATUS
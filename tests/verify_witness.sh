@@ -0,0 +1,45 @@
+# Check that the witnesses written by -c -w and -p -w pass -t
+# usage: verify_witness.sh /path/to/graphmatching [graph files]
+# the graphs default to every instance under this directory, the result is
+# printed as instance,algorithm,result where result is the line written by
+# -t (or "none" if no witness was written), the exit status is 1 if some
+# witness is invalid
+GMBIN=${1:?usage: verify_witness.sh /path/to/graphmatching [graph files]}
+shift
+DIRPATH=$(dirname "$0")
+TMPDIR=$(mktemp -d)
+STATUS=0
+
+if [ $# -eq 0 ]; then
+  set -- $(grep -rl --include="*.txt" "@PartitionA" "$DIRPATH" | sort)
+fi
+
+for GFILE in "$@"; do
+  for FLAG in -c -p; do
+    rm -f "$TMPDIR"/matching "$TMPDIR"/witness "$TMPDIR"/result
+    $GMBIN $FLAG -i "$GFILE" -o "$TMPDIR"/matching -w "$TMPDIR"/witness > /dev/null 2>&1
+
+    if [ ! -f "$TMPDIR"/matching ] || [ ! -f "$TMPDIR"/witness ]; then
+      RESULT=none
+    else
+      # -c checks the one-sided popularity of the matchings of -c
+      VFLAG=
+      if [ "$FLAG" = -c ]; then
+        VFLAG=-c
+      fi
+
+      $GMBIN -t $VFLAG -i "$GFILE" -f "$TMPDIR"/matching -w "$TMPDIR"/witness \
+        -o "$TMPDIR"/result
+      RESULT=$(cat "$TMPDIR"/result 2> /dev/null)
+
+      if [ "$RESULT" != "witness,valid" ]; then
+        STATUS=1
+      fi
+    fi
+
+    echo "$(basename "$GFILE"),$FLAG,$RESULT"
+  done
+done
+
+rm -rf "$TMPDIR"
+exit $STATUS